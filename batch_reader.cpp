@@ -0,0 +1,407 @@
+#include "batch_reader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+#include "parallel.h"
+
+namespace {
+
+#ifdef __linux__
+// Anneaux de soumission et de complétion partagés avec le noyau (équivalent minimal de liburing)
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring() { close(); }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool init(unsigned int entries, std::string* err) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            if (err) *err = std::string("io_uring indisponible : ") + std::strerror(errno);
+            return false;
+        }
+        sqEntries_ = params.sq_entries;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cqRing_ = singleMap ? sqRing_
+                            : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                   IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqesSize_);
+            }
+            if (err) *err = std::string("projection des anneaux io_uring impossible : ") + std::strerror(errno);
+            close();
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // IORING_OP_READ n'existe que depuis Linux 5.6 (-EINVAL en complétion avant) ; la sonde des
+        // opérations date de la même version, donc son absence suffit à écarter les noyaux plus anciens
+        if (!supportsRead()) {
+            if (err) *err = "io_uring sans IORING_OP_READ sur ce noyau";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (sqes_) {
+            munmap(sqes_, sqesSize_);
+            sqes_ = nullptr;
+        }
+        if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+            munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != MAP_FAILED) {
+            munmap(sqRing_, sqRingSize_);
+        }
+        sqRing_ = cqRing_ = MAP_FAILED;
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    unsigned int capacity() const { return sqEntries_; }
+
+    // Lectures préparées que le noyau n'a pas encore prises
+    unsigned int pending() const { return pending_; }
+
+    // Ajoute une lecture à l'anneau de soumission ; le noyau ne la voit qu'au prochain submitAndWait
+    void prepareRead(int fd, void* buffer, unsigned int length, uint64_t offset, uint64_t userData) {
+        const unsigned int tail = *sqTail_;
+        const unsigned int slot = tail & sqMask_;
+        io_uring_sqe& sqe = sqes_[slot];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        sqArray_[slot] = slot;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    // Soumet les lectures préparées (aucune si submit est faux) et attend au moins minComplete
+    // complétions ; -errno en cas d'échec
+    int submitAndWait(unsigned int minComplete, bool submit = true) {
+        for (;;) {
+            long result = syscall(__NR_io_uring_enter, fd_, submit ? pending_ : 0u, minComplete, IORING_ENTER_GETEVENTS,
+                                  nullptr, 0);
+            if (result >= 0) {
+                pending_ -= static_cast<unsigned int>(result);
+                return 0;
+            }
+            if (errno != EINTR) {
+                return -errno;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void forEachCompletion(Fn fn) {
+        unsigned int head = *cqHead_;
+        const unsigned int tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            fn(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    bool supportsRead() const {
+        const unsigned int maxOps = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) + maxOps * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, maxOps) < 0) {
+            return false;
+        }
+        return IORING_OP_READ <= probe->last_op && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    int fd_ = -1;
+    void* sqRing_ = MAP_FAILED;
+    void* cqRing_ = MAP_FAILED;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    unsigned int* sqTail_ = nullptr;
+    unsigned int* sqArray_ = nullptr;
+    unsigned int sqMask_ = 0;
+    unsigned int* cqHead_ = nullptr;
+    unsigned int* cqTail_ = nullptr;
+    unsigned int cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned int sqEntries_ = 0;
+    unsigned int pending_ = 0;
+};
+#endif
+
+struct FileState {
+    int fd = -1;
+    std::vector<char> data;
+    std::string error;
+    size_t outstanding = 0; // requêtes en attente ou en vol
+    bool delivered = false;
+};
+
+struct ReadRequest {
+    size_t file;
+    uint64_t offset;
+    size_t length;
+};
+
+// Ouvre le fichier et alloue son tampon ; faux (avec l'erreur dans state) s'il est illisible
+bool openFile(const std::string& path, FileState& state) {
+    state.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (state.fd < 0) {
+        state.error = "impossible d'ouvrir " + path + " : " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(state.fd, &info) != 0) {
+        state.error = "impossible de lire la taille de " + path;
+        return false;
+    }
+    state.data.resize(static_cast<size_t>(info.st_size));
+    return true;
+}
+
+void closeFile(FileState& state) {
+    if (state.fd >= 0) {
+        close(state.fd);
+        state.fd = -1;
+    }
+}
+
+// Repli : chaque thread lit des fichiers entiers par pread bloquant
+void readWithPread(const std::vector<std::string>& paths, const std::vector<size_t>& files,
+                   const std::function<void(size_t, std::vector<char>&, const std::string&)>& onRead,
+                   unsigned int numThreads, BatchReadStats& stats) {
+    std::atomic<uint64_t> bytes(0);
+    std::atomic<size_t> read(0), requests(0);
+    parallelFor(files.size(), [&](size_t i) {
+        const size_t index = files[i];
+        FileState state;
+        if (openFile(paths[index], state)) {
+            size_t done = 0;
+            while (done < state.data.size()) {
+                ssize_t n = pread(state.fd, state.data.data() + done, state.data.size() - done, static_cast<off_t>(done));
+                ++requests;
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    state.error = "erreur de lecture de " + paths[index] + (n < 0 ? std::string(" : ") + std::strerror(errno) : "");
+                    break;
+                }
+                done += static_cast<size_t>(n);
+            }
+        }
+        closeFile(state);
+        if (state.error.empty()) {
+            bytes += state.data.size();
+            ++read;
+        }
+        onRead(index, state.data, state.error);
+    }, numThreads);
+    stats.bytesRead += bytes;
+    stats.filesRead += read;
+    stats.requests += requests;
+}
+
+} // namespace
+
+void readFilesBatched(const std::vector<std::string>& paths,
+                      const std::function<void(size_t, std::vector<char>&, const std::string&)>& onRead,
+                      const BatchReadOptions& options, BatchReadStats* stats) {
+    BatchReadStats localStats;
+    BatchReadStats& result = stats ? *stats : localStats;
+    result = BatchReadStats();
+
+    std::vector<size_t> allFiles(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        allFiles[i] = i;
+    }
+#ifndef __linux__
+    readWithPread(paths, allFiles, onRead, options.numThreads, result);
+#else
+    IoUring ring;
+    if (options.forcePread || paths.empty() || !ring.init(std::max(1u, options.queueDepth), nullptr)) {
+        readWithPread(paths, allFiles, onRead, options.numThreads, result);
+        return;
+    }
+    result.usedIoUring = true;
+
+    std::vector<FileState> files(paths.size());
+    std::deque<ReadRequest> queued;          // requêtes des fichiers ouverts, pas encore soumises
+    std::vector<ReadRequest> slots;           // requêtes en vol, désignées par user_data
+    std::vector<size_t> freeSlots;
+    const size_t depth = ring.capacity();
+    const size_t requestBytes = std::max<size_t>(options.requestBytes, 4096);
+    size_t nextFile = 0, delivered = 0, inFlight = 0;
+    bool submitted = false;
+
+    auto deliver = [&](size_t index) {
+        FileState& state = files[index];
+        closeFile(state);
+        state.delivered = true;
+        ++delivered;
+        if (state.error.empty()) {
+            result.bytesRead += state.data.size();
+            ++result.filesRead;
+        }
+        onRead(index, state.data, state.error);
+        std::vector<char>().swap(state.data);
+    };
+
+    while (delivered < paths.size()) {
+        // Remplit l'anneau : ouvre les fichiers suivants au fur et à mesure que des places se libèrent
+        while (inFlight < depth) {
+            if (queued.empty()) {
+                if (nextFile == paths.size()) {
+                    break;
+                }
+                const size_t index = nextFile++;
+                FileState& state = files[index];
+                if (!openFile(paths[index], state) || state.data.empty()) {
+                    deliver(index);
+                    continue;
+                }
+                for (uint64_t offset = 0; offset < state.data.size(); offset += requestBytes) {
+                    queued.push_back({index, offset, std::min<size_t>(requestBytes, state.data.size() - offset)});
+                    ++state.outstanding;
+                }
+                continue;
+            }
+            ReadRequest request = queued.front();
+            queued.pop_front();
+            size_t slot = slots.size();
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+                slots[slot] = request;
+            } else {
+                slots.push_back(request);
+            }
+            ring.prepareRead(files[request.file].fd, files[request.file].data.data() + request.offset,
+                             static_cast<unsigned int>(request.length), request.offset, slot);
+            ++inFlight;
+            ++result.requests;
+        }
+        if (inFlight == 0) {
+            continue;
+        }
+
+        const int status = ring.submitAndWait(1);
+        if (status < 0) {
+            if (!submitted) {
+                // Rien n'est en vol : tout est relu par pread (io_uring_enter filtré, par exemple)
+                ring.close();
+                for (FileState& state : files) {
+                    closeFile(state);
+                }
+                std::vector<size_t> remaining;
+                for (size_t i = 0; i < files.size(); ++i) {
+                    if (!files[i].delivered) {
+                        remaining.push_back(i);
+                    }
+                }
+                result.usedIoUring = false;
+                result.requests = 0;
+                readWithPread(paths, remaining, onRead, options.numThreads, result);
+                return;
+            }
+            // Le noyau peut encore écrire dans les tampons des requêtes déjà soumises : on attend leur fin
+            // avant de rendre les fichiers restants en erreur. Si même l'attente échoue, la fermeture de
+            // l'anneau annule les requêtes.
+            const std::string error = std::string("lecture io_uring interrompue : ") + std::strerror(-status);
+            size_t running = inFlight - ring.pending();
+            while (running > 0) {
+                ring.forEachCompletion([&](uint64_t, int) { --running; });
+                if (running > 0) {
+                    const int waited = ring.submitAndWait(1, false);
+                    if (waited < 0 && waited != -EBUSY && waited != -EAGAIN) {
+                        ring.close();
+                        break;
+                    }
+                }
+            }
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (!files[i].delivered) {
+                    files[i].error = error;
+                    deliver(i);
+                }
+            }
+            return;
+        }
+        submitted = true;
+
+        ring.forEachCompletion([&](uint64_t slot, int res) {
+            const ReadRequest request = slots[slot];
+            freeSlots.push_back(static_cast<size_t>(slot));
+            --inFlight;
+            FileState& state = files[request.file];
+            if (res == -EAGAIN || res == -EINTR) {
+                queued.push_front(request);
+                return;
+            }
+            if (res <= 0) {
+                if (state.error.empty()) {
+                    state.error = "erreur de lecture de " + paths[request.file] +
+                                  (res < 0 ? std::string(" : ") + std::strerror(-res) : " (fichier tronqué)");
+                }
+            } else if (static_cast<size_t>(res) < request.length) {
+                // Lecture partielle : le reste est soumis à nouveau
+                queued.push_front({request.file, request.offset + res, request.length - res});
+                return;
+            }
+            if (--state.outstanding == 0) {
+                deliver(request.file);
+            }
+        });
+    }
+#endif
+}
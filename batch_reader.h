@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Lecture groupée de nombreux fichiers : toutes les lectures sont soumises d'un coup à io_uring
+// (appels système directs, sans liburing) et chaque fichier est transmis dès que ses octets sont arrivés,
+// dans l'ordre de fin des lectures. Si io_uring est indisponible (hors Linux, noyau antérieur à 5.6 sans
+// IORING_OP_READ, seccomp), un groupe de threads fait des pread bloquants.
+struct BatchReadOptions {
+    unsigned int queueDepth = 64;  // lectures en vol au plus
+    size_t requestBytes = 4 << 20; // un fichier est lu en requêtes de cette taille au plus
+    unsigned int numThreads = 0;   // threads du repli pread (0 = tous les coeurs)
+    bool forcePread = false;       // ignore io_uring, pour comparer les deux chemins
+};
+
+struct BatchReadStats {
+    bool usedIoUring = false;
+    uint64_t bytesRead = 0;
+    size_t filesRead = 0;
+    size_t requests = 0; // lectures soumises, relectures de fins partielles comprises
+};
+
+// onRead(index, contenu, erreur) est appelé une fois par fichier, erreur vide en cas de succès ; il peut
+// prendre le contenu (std::move). En repli pread, il peut être appelé depuis plusieurs threads à la fois.
+void readFilesBatched(const std::vector<std::string>& paths,
+                      const std::function<void(size_t, std::vector<char>&, const std::string&)>& onRead,
+                      const BatchReadOptions& options = BatchReadOptions(), BatchReadStats* stats = nullptr);
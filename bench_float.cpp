@@ -0,0 +1,139 @@
+// Microbenchmark de la conversion texte -> float des lignes v/vn/vt :
+// tryParseDouble et parseReal3 de tiny_obj_loader, strtof et parseFloat3 (float_parser.cpp).
+//
+//   g++ -std=c++17 -O2 -Idependencies/include bench_float.cpp float_parser.cpp -o bench_float
+//   ./bench_float [fichier.obj] [répétitions]
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include "float_parser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Line {
+    const char* begin; // premier caractère après le mot-clé
+    const char* end;
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// Même découpage que tinyobj::parseReal : jeton délimité par les espaces, puis tryParseDouble
+void parseTinyObj(const char* p, const char* end, float out[3]) {
+    for (int i = 0; i < 3; ++i) {
+        while (p < end && isSpace(*p)) ++p;
+        const char* tokenEnd = p;
+        while (tokenEnd < end && !isSpace(*tokenEnd)) ++tokenEnd;
+        double value = 0.0;
+        tinyobj::tryParseDouble(p, tokenEnd, &value);
+        out[i] = static_cast<float>(value);
+        p = tokenEnd;
+    }
+}
+
+// Chemin réellement emprunté par tinyobj::LoadObj (strspn/strcspn puis tryParseDouble)
+void parseTinyObjReal3(const char* p, const char*, float out[3]) {
+    tinyobj::real_t x, y, z;
+    tinyobj::parseReal3(&x, &y, &z, &p);
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+void parseStrtof(const char* p, const char*, float out[3]) {
+    char* next = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        out[i] = std::strtof(p, &next);
+        p = next;
+    }
+}
+
+void parseNative(const char* p, const char* end, float out[3]) {
+    parseFloat3(p, end, out);
+}
+
+template <typename Parser>
+double run(const char* label, const std::vector<Line>& lines, size_t bytes, std::vector<float>& results, Parser parser) {
+    results.assign(lines.size() * 3, 0.0f);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lines.size(); ++i) {
+        parser(lines[i].begin, lines[i].end, &results[i * 3]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << " : " << seconds * 1000.0 << " ms, "
+              << (bytes / (1024.0 * 1024.0)) / seconds << " Mo/s, "
+              << seconds * 1e9 / (lines.size() * 3.0) << " ns/float" << std::endl;
+    return seconds;
+}
+
+size_t countDifferences(const std::vector<float>& a, const std::vector<float>& b) {
+    size_t diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::memcmp(&a[i], &b[i], sizeof(float)) != 0) ++diff;
+    }
+    return diff;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "drone.obj";
+    const int repeat = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Impossible d'ouvrir " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Ne garde que les lignes v/vn/vt, dupliquées pour obtenir une durée mesurable.
+    // Chaque ligne est terminée par '\0', comme les copies de ligne analysées par tiny_obj_loader.
+    std::string vertexLines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.size() > 2 && line[0] == 'v' && (isSpace(line[1]) || line[1] == 'n' || line[1] == 't')) {
+            vertexLines += line;
+            vertexLines += '\0';
+        }
+    }
+    std::string text;
+    text.reserve(vertexLines.size() * repeat);
+    for (int r = 0; r < repeat; ++r) {
+        text += vertexLines;
+    }
+
+    std::vector<Line> lines;
+    size_t valueBytes = 0;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\0', pos);
+        const char* begin = text.data() + pos + (text[pos + 1] == ' ' ? 2 : 3);
+        const char* end = text.data() + eol;
+        lines.push_back({begin, end});
+        valueBytes += static_cast<size_t>(end - begin);
+        pos = eol + 1;
+    }
+    std::cout << lines.size() << " lignes, " << valueBytes / (1024.0 * 1024.0) << " Mo de nombres" << std::endl;
+
+    std::vector<float> reference, tinyobjResults, real3Results, nativeResults;
+    double strtofTime = run("strtof             ", lines, valueBytes, reference, parseStrtof);
+    double tinyobjTime = run("tryParseDouble     ", lines, valueBytes, tinyobjResults, parseTinyObj);
+    double real3Time = run("tinyobj::parseReal3", lines, valueBytes, real3Results, parseTinyObjReal3);
+    double nativeTime = run("parseFloat3        ", lines, valueBytes, nativeResults, parseNative);
+
+    std::cout << "Accélération de parseFloat3 : " << tinyobjTime / nativeTime << "x / tryParseDouble, "
+              << real3Time / nativeTime << "x / parseReal3, " << strtofTime / nativeTime << "x / strtof" << std::endl;
+    // strtof arrondit correctement : toute différence est une erreur d'arrondi
+    std::cout << "Valeurs différentes de strtof : tryParseDouble " << countDifferences(reference, tinyobjResults)
+              << ", parseReal3 " << countDifferences(reference, real3Results)
+              << ", parseFloat3 " << countDifferences(reference, nativeResults) << std::endl;
+    return EXIT_SUCCESS;
+}
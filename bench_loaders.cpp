@@ -0,0 +1,270 @@
+// Comparaison des chargeurs OBJ sur drone.obj et sur des grilles générées de grande taille :
+// Assimp (mêmes post-traitements que loadModel), tinyobj::LoadObj seul, loadObjParallel,
+// loadObjMapped et l'arène de géométrie. Chaque mesure tourne dans un processus fils, pour que le
+// pic de mémoire résidente (VmHWM) soit celui du chargeur ; les allocations comptées sont les appels
+// à operator new (Assimp compris), pas les malloc directs.
+//
+//   g++ -std=c++17 -O2 -Idependencies/include bench_loaders.cpp float_parser.cpp geometry_arena.cpp mapped_file.cpp
+//       memory_usage.cpp mesh_cache.cpp obj_index.cpp obj_parser.cpp weld.cpp tiny_obj_loader.cc -lassimp -lpthread
+//       -o bench_loaders
+//   ./bench_loaders [fichier.obj ...] [--grid=côté ...] [--repeat=N] [--dir=dossier]
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "geometry_arena.h"
+#include "memory_usage.h"
+#include "obj_parser.h"
+#include "tiny_obj_loader.h"
+
+namespace {
+
+std::atomic<uint64_t> allocationCount(0);
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+struct LoadResult {
+    bool ok = false;
+    double milliseconds = 0.0;
+    uint64_t peakResident = 0;
+    uint64_t allocations = 0;
+    uint64_t vertices = 0;
+    uint64_t indices = 0;
+};
+
+struct Loader {
+    const char* name;
+    bool (*load)(const std::string& path, LoadResult& result);
+};
+
+bool loadAssimp(const std::string& path, LoadResult& result) {
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        return false;
+    }
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        result.vertices += scene->mMeshes[i]->mNumVertices;
+        for (unsigned int f = 0; f < scene->mMeshes[i]->mNumFaces; ++f) {
+            result.indices += scene->mMeshes[i]->mFaces[f].mNumIndices;
+        }
+    }
+    return true;
+}
+
+// tiny_obj_loader tel quel : attributs partagés, indices (v, vt, vn) par coin, sans fusion
+bool loadTinyObj(const std::string& path, LoadResult& result) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), nullptr, true)) {
+        return false;
+    }
+    result.vertices = attrib.vertices.size() / 3;
+    for (const tinyobj::shape_t& shape : shapes) {
+        result.indices += shape.mesh.indices.size();
+    }
+    return true;
+}
+
+void countModel(const ObjModel& model, LoadResult& result) {
+    for (const ObjMesh& mesh : model.meshes) {
+        result.vertices += mesh.vertexCount();
+        result.indices += mesh.indices.size();
+    }
+}
+
+bool loadParallel(const std::string& path, LoadResult& result) {
+    ObjModel model;
+    if (!loadObjParallel(path, model, nullptr)) {
+        return false;
+    }
+    countModel(model, result);
+    return true;
+}
+
+bool loadMapped(const std::string& path, LoadResult& result) {
+    ObjModel model;
+    if (!loadObjMapped(path, model, nullptr)) {
+        return false;
+    }
+    countModel(model, result);
+    return true;
+}
+
+bool loadArena(const std::string& path, LoadResult& result) {
+    GeometryArena arena;
+    if (!arena.load(path, nullptr)) {
+        return false;
+    }
+    result.vertices = arena.vertexCount();
+    result.indices = arena.indexCount();
+    return true;
+}
+
+const Loader kLoaders[] = {
+    {"assimp", loadAssimp},
+    {"tinyobj", loadTinyObj},
+    {"parallel-obj", loadParallel},
+    {"mmap-obj", loadMapped},
+    {"arena-obj", loadArena},
+};
+
+// Charge dans un processus fils et renvoie le résultat par un tube
+LoadResult measure(const Loader& loader, const std::string& path) {
+    LoadResult result;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        const uint64_t allocationsBefore = allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+        result.ok = loader.load(path, result);
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.allocations = allocationCount.load() - allocationsBefore;
+        result.peakResident = peakResidentBytes();
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &result, sizeof(result)) != sizeof(result)) {
+            result.ok = false;
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return result;
+}
+
+// Grille de côté x côté sommets avec uv et normales, découpée en 8 objets de bandes de quads
+bool generateGrid(const std::string& path, int side) {
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) {
+        return true; // déjà générée
+    }
+    std::ofstream out(path);
+    out << std::fixed << std::setprecision(6);
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            const float u = float(x) / (side - 1), v = float(y) / (side - 1);
+            out << "v " << u * 10.0f << " " << 0.1f * ((x * 7 + y * 13) % 17) << " " << v * 10.0f << "\n"
+                << "vt " << u << " " << v << "\n"
+                << "vn 0.000000 1.000000 0.000000\n";
+        }
+    }
+    const int rowsPerObject = std::max(1, (side - 1 + 7) / 8);
+    for (int y = 0; y + 1 < side; ++y) {
+        if (y % rowsPerObject == 0) {
+            out << "o bande" << y / rowsPerObject << "\n";
+        }
+        for (int x = 0; x + 1 < side; ++x) {
+            const int a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+            out << "f " << a << "/" << a << "/" << a << " " << b << "/" << b << "/" << b << " " << c << "/" << c << "/"
+                << c << " " << d << "/" << d << "/" << d << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    std::vector<int> grids;
+    int repeat = 3;
+    std::string dir = ".";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--grid=", 0) == 0) {
+            grids.push_back(std::atoi(arg.c_str() + 7));
+        } else if (arg.rfind("--repeat=", 0) == 0) {
+            repeat = std::max(1, std::atoi(arg.c_str() + 9));
+        } else if (arg.rfind("--dir=", 0) == 0) {
+            dir = arg.substr(6);
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() && grids.empty()) {
+        paths.push_back("drone.obj");
+        grids = {300, 1000};
+    }
+    for (int side : grids) {
+        if (side < 2) {
+            std::cerr << "--grid : côté invalide" << std::endl;
+            return EXIT_FAILURE;
+        }
+        const std::string path = dir + "/grille_" + std::to_string(side) + ".obj";
+        if (!generateGrid(path, side)) {
+            std::cerr << "Impossible d'écrire " << path << std::endl;
+            return EXIT_FAILURE;
+        }
+        paths.push_back(path);
+    }
+
+    // Meilleur temps sur `repeat` essais ; pic de mémoire et compteurs du même essai
+    std::cout << std::fixed << std::setprecision(1);
+    for (const std::string& path : paths) {
+        struct stat info;
+        const double megabytes = stat(path.c_str(), &info) == 0 ? info.st_size / (1024.0 * 1024.0) : 0.0;
+        std::cout << path << " (" << megabytes << " Mo)" << std::endl;
+        std::cout << "  chargeur          ms     Mo/s   pic RSS Mo   allocations      sommets      indices" << std::endl;
+        for (const Loader& loader : kLoaders) {
+            LoadResult best;
+            for (int r = 0; r < repeat; ++r) {
+                LoadResult result = measure(loader, path);
+                if (result.ok && (!best.ok || result.milliseconds < best.milliseconds)) {
+                    best = result;
+                }
+            }
+            std::cout << "  " << std::left << std::setw(13) << loader.name << std::right;
+            if (!best.ok) {
+                std::cout << "  échec" << std::endl;
+                continue;
+            }
+            std::cout << std::setw(9) << best.milliseconds << std::setw(9) << megabytes / (best.milliseconds / 1000.0)
+                      << std::setw(13) << best.peakResident / (1024.0 * 1024.0) << std::setw(14) << best.allocations
+                      << std::setw(13) << best.vertices << std::setw(13) << best.indices << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
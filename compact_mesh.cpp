@@ -0,0 +1,150 @@
+#include "compact_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) {
+        // Infini ou NaN (on garde un bit de mantisse pour rester NaN)
+        return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u); // dépasse 65504 après arrondi
+    }
+    if (magnitude < 0x38800000u) {
+        // Sous-normal en demi-précision : décalage de la mantisse implicite, arrondi au pair
+        if (magnitude < 0x33000000u) {
+            return sign;
+        }
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+        const uint32_t shift = 126 - exponent; // 14 + (112 - exponent)
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    // Normal : rebias de l'exposant et arrondi au pair des 13 bits perdus
+    uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const uint32_t remainder = magnitude & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+    uint32_t bits;
+    if (exponent == 0x1fu) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Sous-normal : normalisation de la mantisse
+        uint32_t e = 113;
+        while (!(mantissa & 0x400u)) {
+            mantissa <<= 1;
+            --e;
+        }
+        bits = sign | (e << 23) | ((mantissa & 0x3ffu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+namespace {
+
+int16_t toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float signNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+} // namespace
+
+void encodeOctahedral(const float normal[3], int16_t out[2]) {
+    const float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    if (l1 == 0.0f) {
+        out[0] = out[1] = 0;
+        return;
+    }
+    float x = normal[0] / l1;
+    float y = normal[1] / l1;
+    if (normal[2] < 0.0f) {
+        // Hémisphère inférieur replié sur les coins du carré
+        const float fx = (1.0f - std::fabs(y)) * signNotZero(x);
+        const float fy = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    out[0] = toSnorm16(x);
+    out[1] = toSnorm16(y);
+}
+
+void decodeOctahedral(const int16_t encoded[2], float out[3]) {
+    float x = encoded[0] / 32767.0f;
+    float y = encoded[1] / 32767.0f;
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    const float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    const float length = std::sqrt(x * x + y * y + z * z);
+    const float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+    out[0] = x * inverse;
+    out[1] = y * inverse;
+    out[2] = z * inverse;
+}
+
+CompactMesh compactMesh(const MeshView& mesh, const MeshBounds& bounds) {
+    CompactMesh out;
+    out.name = std::string(mesh.name);
+    out.bounds = bounds;
+    out.hasNormals = mesh.normals != nullptr;
+    out.hasTexcoords = mesh.texcoords != nullptr;
+
+    float inverseScale[3];
+    for (int c = 0; c < 3; ++c) {
+        const float extent = bounds.max[c] - bounds.min[c];
+        out.scale[c] = extent > 0.0f ? extent / 65535.0f : 0.0f;
+        inverseScale[c] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+    }
+
+    out.vertices.resize(mesh.vertexCount);
+    for (size_t i = 0; i < mesh.vertexCount; ++i) {
+        CompactVertex& v = out.vertices[i];
+        for (int c = 0; c < 3; ++c) {
+            const float q = (mesh.positions[i * 3 + c] - bounds.min[c]) * inverseScale[c];
+            v.position[c] = static_cast<uint16_t>(std::lround(std::clamp(q, 0.0f, 65535.0f)));
+        }
+        if (mesh.normals) {
+            encodeOctahedral(mesh.normals + i * 3, v.normal);
+        } else {
+            v.normal[0] = v.normal[1] = 0;
+        }
+        if (mesh.texcoords) {
+            v.texcoord[0] = floatToHalf(mesh.texcoords[i * 2]);
+            v.texcoord[1] = floatToHalf(mesh.texcoords[i * 2 + 1]);
+        } else {
+            v.texcoord[0] = v.texcoord[1] = 0;
+        }
+    }
+    out.indices.assign(mesh.indices, mesh.indices + mesh.indexCount);
+    return out;
+}
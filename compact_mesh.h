@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh_view.h"
+
+// Sommet compact de 14 octets (au lieu de 36 pour trois aiVector3D) :
+// position quantifiée sur 16 bits par axe dans la boîte englobante du mesh,
+// normale en encodage octaédrique (2 x 16 bits signés), uv en demi-flottants.
+struct CompactVertex {
+    uint16_t position[3];
+    int16_t normal[2];
+    uint16_t texcoord[2];
+};
+
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t half);
+
+void encodeOctahedral(const float normal[3], int16_t out[2]);
+void decodeOctahedral(const int16_t encoded[2], float out[3]);
+
+struct CompactMesh {
+    std::string name;
+    MeshBounds bounds;
+    float scale[3]; // (max - min) / 65535 par axe
+    std::vector<CompactVertex> vertices;
+    std::vector<unsigned int> indices;
+    bool hasNormals = false;
+    bool hasTexcoords = false;
+
+    void decodePosition(unsigned int i, float out[3]) const {
+        const CompactVertex& v = vertices[i];
+        out[0] = bounds.min[0] + v.position[0] * scale[0];
+        out[1] = bounds.min[1] + v.position[1] * scale[1];
+        out[2] = bounds.min[2] + v.position[2] * scale[2];
+    }
+    void decodeNormal(unsigned int i, float out[3]) const { decodeOctahedral(vertices[i].normal, out); }
+    void decodeTexcoord(unsigned int i, float out[2]) const {
+        out[0] = halfToFloat(vertices[i].texcoord[0]);
+        out[1] = halfToFloat(vertices[i].texcoord[1]);
+    }
+
+    size_t byteSize() const {
+        return vertices.size() * sizeof(CompactVertex) + indices.size() * sizeof(unsigned int);
+    }
+};
+
+// Quantifie un mesh par rapport à ses bornes (celles de computeBounds ou du cache)
+CompactMesh compactMesh(const MeshView& mesh, const MeshBounds& bounds);
@@ -0,0 +1,130 @@
+#include "file_watcher.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+#ifndef __linux__
+const int kPollIntervalMs = 250;
+
+// Date de modification et taille, ou taille -1 si le fichier est absent (export en cours)
+void statFile(const std::string& path, int64_t& mtime, int64_t& size) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        mtime = 0;
+        size = -1;
+        return;
+    }
+    mtime = static_cast<int64_t>(info.st_mtime);
+    size = static_cast<int64_t>(info.st_size);
+}
+#endif
+
+} // namespace
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool FileWatcher::watch(const std::string& path, std::string* err) {
+    stop();
+    const size_t slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    fileName_ = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+        if (err) *err = std::string("inotify indisponible : ") + std::strerror(errno);
+        return false;
+    }
+    watch_ = inotify_add_watch(fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+    if (watch_ < 0) {
+        if (err) *err = "impossible de surveiller " + directory + " : " + std::strerror(errno);
+        stop();
+        return false;
+    }
+    watching_ = true;
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    watch_ = -1;
+    watching_ = false;
+}
+
+bool FileWatcher::poll() {
+    if (fd_ < 0) {
+        return false;
+    }
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break; // EAGAIN : plus d'événement en attente
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && fileName_ == event->name) {
+                changed = true;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    return changed;
+}
+
+#else
+
+bool FileWatcher::watch(const std::string& path, std::string* err) {
+    stop();
+    statFile(path, mtime_, size_);
+    if (size_ < 0) {
+        if (err) *err = "impossible de surveiller " + path + " : " + std::strerror(errno);
+        return false;
+    }
+    path_ = path;
+    lastCheck_ = std::chrono::steady_clock::now();
+    watching_ = true;
+    return true;
+}
+
+void FileWatcher::stop() {
+    path_.clear();
+    watching_ = false;
+}
+
+bool FileWatcher::poll() {
+    if (!watching_) {
+        return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCheck_).count() < kPollIntervalMs) {
+        return false;
+    }
+    lastCheck_ = now;
+    int64_t mtime = 0, size = 0;
+    statFile(path_, mtime, size);
+    if (mtime == mtime_ && size == size_) {
+        return false;
+    }
+    mtime_ = mtime;
+    size_ = size;
+    return true;
+}
+
+#endif
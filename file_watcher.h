@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Surveillance d'un fichier, interrogée sans blocage (depuis la boucle GLUT).
+// Sous Linux, inotify surveille le dossier, pour suivre aussi les exports qui remplacent le fichier
+// par renommage d'un fichier temporaire. Ailleurs, la date et la taille du fichier sont relevées
+// au plus quatre fois par seconde.
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool watch(const std::string& path, std::string* err = nullptr);
+    void stop();
+
+    // Vide les événements en attente ; vrai si l'un d'eux concerne le fichier surveillé
+    bool poll();
+
+    bool isWatching() const { return watching_; }
+
+private:
+    bool watching_ = false;
+    int fd_ = -1;
+    int watch_ = -1;
+    std::string fileName_;
+    // Repli par interrogation
+    std::string path_;
+    int64_t mtime_ = 0;
+    int64_t size_ = -1;
+    std::chrono::steady_clock::time_point lastCheck_;
+};
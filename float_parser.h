@@ -0,0 +1,13 @@
+#pragma once
+
+// Conversion texte -> float pour les lignes v/vn/vt des fichiers OBJ.
+// Les chiffres sont lus 8 par 8 dans un registre 64 bits (SWAR) et la conversion est exacte
+// (arrondi au plus proche, comme strtof) grâce à l'algorithme d'Eisel-Lemire.
+
+// Lit un nombre à partir de first sans dépasser last. Retourne la position qui suit le nombre,
+// ou nullptr si aucun nombre n'a été reconnu (value n'est alors pas modifiée).
+const char* parseFloat(const char* first, const char* last, float& value);
+
+// Lit trois nombres séparés par des espaces ou tabulations (ligne `v` ou `vn`).
+// Les composantes absentes valent 0. Retourne la position qui suit le dernier nombre lu.
+const char* parseFloat3(const char* first, const char* last, float values[3]);
@@ -0,0 +1,351 @@
+#include "geometry_arena.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <istream>
+
+#include "mapped_file.h"
+#include "obj_tokenizer.h"
+#include "parallel.h"
+#include "tiny_obj_loader.h"
+#include "weld.h"
+
+// État de l'analyse, renseigné par les callbacks de tinyobj : attributs du fichier, puis sommets fusionnés
+// et indices écrits aux curseurs dans l'arène de lecture (dimensionnée pour un sommet par coin au plus)
+struct ArenaIngest {
+    static constexpr uint32_t kMissing = UINT32_MAX;
+    static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+    float* filePositions = nullptr;
+    float* fileNormals = nullptr;   // nullptr si le fichier n'a pas de vn
+    float* fileTexcoords = nullptr; // nullptr si le fichier n'a pas de vt
+    float* positions = nullptr;
+    float* normals = nullptr;
+    float* texcoords = nullptr;
+    unsigned int* indices = nullptr;
+    size_t capacityV = 0, capacityVn = 0, capacityVt = 0, capacityCorners = 0;
+    size_t v = 0, vn = 0, vt = 0, corners = 0;
+    size_t vertices = 0;
+    bool overflow = false;
+    bool badIndex = false;
+    std::string badObject;
+    std::vector<ArenaMesh> meshes;
+
+    // Sommets de l'objet en cours : table à adressage ouvert de leurs indices locaux, clés à part
+    std::vector<VertexKey> keys;
+    std::vector<uint32_t> table;
+
+    // Indice 0-based d'un indice OBJ (négatif : relatif aux attributs déjà lus) ; kMissing s'il est
+    // absent (0), et `bad` levé s'il est hors limites
+    static uint32_t resolve(int raw, size_t count, bool& bad) {
+        if (raw > 0 && static_cast<size_t>(raw) <= count) {
+            return static_cast<uint32_t>(raw - 1);
+        }
+        if (raw < 0 && static_cast<size_t>(-raw) <= count) {
+            return static_cast<uint32_t>(count + raw);
+        }
+        bad |= raw != 0;
+        return kMissing;
+    }
+
+    void growTable() {
+        std::vector<uint32_t> larger(std::max<size_t>(table.size() * 2, 64), kEmptySlot);
+        const size_t mask = larger.size() - 1;
+        for (uint32_t local = 0; local < keys.size(); ++local) {
+            size_t slot = VertexKeyHash()(keys[local]) & mask;
+            while (larger[slot] != kEmptySlot) {
+                slot = (slot + 1) & mask;
+            }
+            larger[slot] = local;
+        }
+        table.swap(larger);
+    }
+
+    // Indice local du sommet (position, normale, uv) dans l'objet en cours, ajouté s'il est nouveau
+    uint32_t vertexFor(const float* position, const float* normal, const float* texcoord) {
+        const VertexKey key = makeVertexKey(position, normal, texcoord, 0.0f);
+        if ((keys.size() + 1) * 2 > table.size()) {
+            growTable();
+        }
+        const size_t mask = table.size() - 1;
+        size_t slot = VertexKeyHash()(key) & mask;
+        while (table[slot] != kEmptySlot) {
+            if (keys[table[slot]] == key) {
+                return table[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+        const uint32_t local = static_cast<uint32_t>(keys.size());
+        table[slot] = local;
+        keys.push_back(key);
+        std::memcpy(positions + vertices * 3, position, 3 * sizeof(float));
+        if (normals) {
+            std::memcpy(normals + vertices * 3, normal, 3 * sizeof(float));
+        }
+        if (texcoords) {
+            std::memcpy(texcoords + vertices * 2, texcoord, 2 * sizeof(float));
+        }
+        ++vertices;
+        return local;
+    }
+
+    static void onVertex(void* userData, tinyobj::real_t x, tinyobj::real_t y, tinyobj::real_t z, tinyobj::real_t) {
+        ArenaIngest& ingest = *static_cast<ArenaIngest*>(userData);
+        if (ingest.v == ingest.capacityV) {
+            ingest.overflow = true;
+            return;
+        }
+        float* out = ingest.filePositions + ingest.v++ * 3;
+        out[0] = x;
+        out[1] = y;
+        out[2] = z;
+    }
+
+    static void onNormal(void* userData, tinyobj::real_t x, tinyobj::real_t y, tinyobj::real_t z) {
+        ArenaIngest& ingest = *static_cast<ArenaIngest*>(userData);
+        if (ingest.vn == ingest.capacityVn) {
+            ingest.overflow = true;
+            return;
+        }
+        float* out = ingest.fileNormals + ingest.vn++ * 3;
+        out[0] = x;
+        out[1] = y;
+        out[2] = z;
+    }
+
+    static void onTexcoord(void* userData, tinyobj::real_t u, tinyobj::real_t v, tinyobj::real_t) {
+        ArenaIngest& ingest = *static_cast<ArenaIngest*>(userData);
+        if (ingest.vt == ingest.capacityVt) {
+            ingest.overflow = true;
+            return;
+        }
+        float* out = ingest.fileTexcoords + ingest.vt++ * 2;
+        out[0] = u;
+        out[1] = 1.0f - v;
+    }
+
+    // Triangulation en éventail ; chaque coin est résolu en sommet fusionné de l'objet en cours
+    static void onFace(void* userData, tinyobj::index_t* faceIndices, int numIndices) {
+        static const float kDefaultNormal[3] = {0.0f, 0.0f, 1.0f};
+        static const float kDefaultTexcoord[2] = {0.0f, 0.0f};
+        ArenaIngest& ingest = *static_cast<ArenaIngest*>(userData);
+        if (numIndices < 3) {
+            return;
+        }
+        const size_t count = size_t(numIndices - 2) * 3;
+        if (count > ingest.capacityCorners - ingest.corners) {
+            ingest.overflow = true;
+            return;
+        }
+        uint32_t corners[3][3]; // position, normale, uv de chaque coin du triangle
+        for (int k = 2; k < numIndices; ++k) {
+            const int faceCorners[3] = {0, k - 1, k};
+            bool bad = false;
+            for (int c = 0; c < 3; ++c) {
+                const tinyobj::index_t& index = faceIndices[faceCorners[c]];
+                corners[c][0] = resolve(index.vertex_index, ingest.v, bad);
+                corners[c][1] = resolve(index.normal_index, ingest.vn, bad);
+                corners[c][2] = resolve(index.texcoord_index, ingest.vt, bad);
+                bad |= corners[c][0] == kMissing;
+            }
+            if (bad) {
+                if (!ingest.badIndex) {
+                    ingest.badObject = ingest.meshes.empty() ? "defaultobject" : ingest.meshes.back().name;
+                }
+                ingest.badIndex = true;
+                return;
+            }
+            for (int c = 0; c < 3; ++c) {
+                const float* position = ingest.filePositions + size_t(corners[c][0]) * 3;
+                const float* normal = !ingest.normals ? nullptr
+                                      : corners[c][1] != kMissing ? ingest.fileNormals + size_t(corners[c][1]) * 3
+                                                                  : kDefaultNormal;
+                const float* texcoord = !ingest.texcoords ? nullptr
+                                        : corners[c][2] != kMissing ? ingest.fileTexcoords + size_t(corners[c][2]) * 2
+                                                                    : kDefaultTexcoord;
+                ingest.indices[ingest.corners++] = ingest.vertexFor(position, normal, texcoord);
+            }
+        }
+    }
+
+    static void onObject(void* userData, const char* name) {
+        ArenaIngest& ingest = *static_cast<ArenaIngest*>(userData);
+        if (ingest.meshes.empty() && ingest.corners > 0) {
+            ingest.meshes.push_back(ArenaMesh{"defaultobject", 0, 0, 0, 0, MeshBounds()});
+        }
+        std::string objectName(name);
+        while (!objectName.empty() && (objectName.back() == ' ' || objectName.back() == '\t' || objectName.back() == '\r')) {
+            objectName.pop_back();
+        }
+        ingest.meshes.push_back(ArenaMesh{objectName, ingest.vertices, 0, ingest.corners, 0, MeshBounds()});
+        // Les indices d'un objet ne désignent que ses propres sommets
+        ingest.keys.clear();
+        ingest.table.assign(64, kEmptySlot);
+    }
+};
+
+namespace {
+
+const size_t kSectionAlignment = 16;
+
+size_t alignUp(size_t offset) {
+    return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+struct LineCounts {
+    size_t v = 0, vn = 0, vt = 0, corners = 0;
+};
+
+// Premier passage : nombre d'attributs et de coins de triangles, pour dimensionner l'arène
+LineCounts countLines(const char* data, size_t size) {
+    LineCounts counts;
+    ObjCursor cursor(data, data + size);
+    while (!cursor.atEnd()) {
+        cursor.skipSpaces();
+        if (cursor.keyword("v")) {
+            ++counts.v;
+        } else if (cursor.keyword("vn")) {
+            ++counts.vn;
+        } else if (cursor.keyword("vt")) {
+            ++counts.vt;
+        } else if (cursor.keyword("f")) {
+            size_t tokens = 0;
+            while (!cursor.atLineEnd()) {
+                cursor.skipSpaces();
+                if (cursor.atLineEnd()) {
+                    break;
+                }
+                while (cursor.p < cursor.end && *cursor.p != ' ' && *cursor.p != '\t' && !cursor.atLineEnd()) {
+                    ++cursor.p;
+                }
+                ++tokens;
+            }
+            counts.corners += tokens >= 3 ? (tokens - 2) * 3 : 0;
+        }
+        cursor.nextLine();
+    }
+    return counts;
+}
+
+} // namespace
+
+bool GeometryArena::load(const std::string& path, std::string* err) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    const LineCounts counts = countLines(file.data(), file.size());
+
+    // Arène de lecture : attributs du fichier, puis sommets (au plus un par coin) et indices
+    size_t offsets[7];
+    size_t bytes = 0;
+    const size_t sectionBytes[7] = {counts.v * 3 * sizeof(float), counts.vn * 3 * sizeof(float),
+                                    counts.vt * 2 * sizeof(float), counts.corners * 3 * sizeof(float),
+                                    counts.vn ? counts.corners * 3 * sizeof(float) : 0,
+                                    counts.vt ? counts.corners * 2 * sizeof(float) : 0,
+                                    counts.corners * sizeof(unsigned int)};
+    for (int i = 0; i < 7; ++i) {
+        offsets[i] = bytes;
+        bytes = alignUp(bytes + sectionBytes[i]);
+    }
+    std::unique_ptr<unsigned char[]> parse(new unsigned char[bytes > 0 ? bytes : 1]);
+    ArenaIngest ingest;
+    ingest.filePositions = reinterpret_cast<float*>(parse.get() + offsets[0]);
+    ingest.fileNormals = counts.vn ? reinterpret_cast<float*>(parse.get() + offsets[1]) : nullptr;
+    ingest.fileTexcoords = counts.vt ? reinterpret_cast<float*>(parse.get() + offsets[2]) : nullptr;
+    ingest.positions = reinterpret_cast<float*>(parse.get() + offsets[3]);
+    ingest.normals = counts.vn ? reinterpret_cast<float*>(parse.get() + offsets[4]) : nullptr;
+    ingest.texcoords = counts.vt ? reinterpret_cast<float*>(parse.get() + offsets[5]) : nullptr;
+    ingest.indices = reinterpret_cast<unsigned int*>(parse.get() + offsets[6]);
+    ingest.capacityV = counts.v;
+    ingest.capacityVn = counts.vn;
+    ingest.capacityVt = counts.vt;
+    ingest.capacityCorners = counts.corners;
+    ingest.table.assign(64, ArenaIngest::kEmptySlot);
+
+    tinyobj::callback_t callbacks;
+    callbacks.vertex_cb = &ArenaIngest::onVertex;
+    callbacks.normal_cb = &ArenaIngest::onNormal;
+    callbacks.texcoord_cb = &ArenaIngest::onTexcoord;
+    callbacks.index_cb = &ArenaIngest::onFace;
+    callbacks.object_cb = &ArenaIngest::onObject;
+    MemoryStreamBuf buffer(file.data(), file.data() + file.size());
+    std::istream stream(&buffer);
+    tinyobj::LoadObjWithCallback(stream, callbacks, &ingest);
+
+    meshes_.clear();
+    if (ingest.overflow) {
+        if (err) *err = "le fichier a changé pendant le chargement : " + path;
+        return false;
+    }
+    if (ingest.badIndex) {
+        if (err) *err = "indice de face hors limites dans l'objet " + ingest.badObject;
+        return false;
+    }
+
+    // Plages des objets (les objets sans face sont retirés)
+    std::vector<ArenaMesh>& parsed = ingest.meshes;
+    if (parsed.empty()) {
+        parsed.push_back(ArenaMesh{"defaultobject", 0, 0, 0, 0, MeshBounds()});
+    }
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        const bool last = i + 1 == parsed.size();
+        parsed[i].vertexCount = (last ? ingest.vertices : parsed[i + 1].firstVertex) - parsed[i].firstVertex;
+        parsed[i].indexCount = (last ? ingest.corners : parsed[i + 1].firstIndex) - parsed[i].firstIndex;
+        if (parsed[i].indexCount > 0) {
+            meshes_.push_back(std::move(parsed[i]));
+        }
+    }
+
+    // Allocation définitive à la taille exacte : sommets fusionnés et indices
+    positionCount_ = ingest.v;
+    vertexCount_ = ingest.vertices;
+    indexCount_ = ingest.corners;
+    const size_t finalBytes[4] = {vertexCount_ * 3 * sizeof(float), counts.vn ? vertexCount_ * 3 * sizeof(float) : 0,
+                                  counts.vt ? vertexCount_ * 2 * sizeof(float) : 0, indexCount_ * sizeof(unsigned int)};
+    const void* sources[4] = {ingest.positions, ingest.normals, ingest.texcoords, ingest.indices};
+    bytes = 0;
+    for (int i = 0; i < 4; ++i) {
+        offsets[i] = bytes;
+        bytes = alignUp(bytes + finalBytes[i]);
+    }
+    storage_.reset(new unsigned char[bytes > 0 ? bytes : 1]);
+    byteSize_ = bytes;
+    for (int i = 0; i < 4; ++i) {
+        if (finalBytes[i] > 0) {
+            std::memcpy(storage_.get() + offsets[i], sources[i], finalBytes[i]);
+        }
+    }
+    positions_ = reinterpret_cast<float*>(storage_.get() + offsets[0]);
+    normals_ = counts.vn ? reinterpret_cast<float*>(storage_.get() + offsets[1]) : nullptr;
+    texcoords_ = counts.vt ? reinterpret_cast<float*>(storage_.get() + offsets[2]) : nullptr;
+    indices_ = reinterpret_cast<unsigned int*>(storage_.get() + offsets[3]);
+    parse.reset();
+
+    parallelFor(meshes_.size(), [&](size_t m) {
+        ArenaMesh& mesh = meshes_[m];
+        mesh.bounds = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+        for (size_t v = mesh.firstVertex; v < mesh.firstVertex + mesh.vertexCount; ++v) {
+            for (int k = 0; k < 3; ++k) {
+                const float value = positions_[v * 3 + k];
+                mesh.bounds.min[k] = value < mesh.bounds.min[k] ? value : mesh.bounds.min[k];
+                mesh.bounds.max[k] = value > mesh.bounds.max[k] ? value : mesh.bounds.max[k];
+            }
+        }
+    });
+    return true;
+}
+
+MeshView GeometryArena::view(size_t mesh) const {
+    const ArenaMesh& source = meshes_[mesh];
+    MeshView view;
+    view.name = source.name;
+    view.positions = positions_ + source.firstVertex * 3;
+    view.normals = normals_ ? normals_ + source.firstVertex * 3 : nullptr;
+    view.texcoords = texcoords_ ? texcoords_ + source.firstVertex * 2 : nullptr;
+    view.indices = indices_ + source.firstIndex;
+    view.vertexCount = source.vertexCount;
+    view.indexCount = source.indexCount;
+    return view;
+}
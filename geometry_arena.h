@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mesh_view.h"
+
+// Plages d'un objet `o` dans l'arène : ses sommets, puis ses indices (relatifs à firstVertex)
+struct ArenaMesh {
+    std::string name;
+    size_t firstVertex = 0;
+    size_t vertexCount = 0;
+    size_t firstIndex = 0;
+    size_t indexCount = 0;
+    MeshBounds bounds;
+};
+
+// Géométrie de tout un modèle OBJ dans une seule allocation, en tableaux séparés (SoA) prêts pour
+// glDrawElements : positions, normales et uv des sommets (UV inversées comme avec aiProcess_FlipUVs),
+// puis les indices des triangles. Un premier passage compte les lignes pour dimensionner l'arène, puis
+// tinyobj::LoadObjWithCallback y écrit les faces directement, sans aiScene ni allocation par mesh :
+// chaque coin est fusionné à la volée, dans son objet, avec les sommets de même clé que le module weld
+// (valeurs exactes), et la géométrie est enfin recopiée dans une allocation à sa taille.
+class GeometryArena {
+public:
+    bool load(const std::string& path, std::string* err);
+
+    // Vue sur les tableaux d'un objet, valide tant que l'arène n'est pas rechargée
+    MeshView view(size_t mesh) const;
+
+    size_t positionCount() const { return positionCount_; } // lignes v du fichier
+    size_t vertexCount() const { return vertexCount_; }     // sommets après fusion des coins
+    size_t indexCount() const { return indexCount_; }
+    const std::vector<ArenaMesh>& meshes() const { return meshes_; }
+
+    // Taille de l'allocation unique
+    size_t byteSize() const { return byteSize_; }
+
+private:
+    std::unique_ptr<unsigned char[]> storage_;
+    size_t byteSize_ = 0;
+    float* positions_ = nullptr;
+    float* normals_ = nullptr;   // nullptr si le fichier n'a pas de vn
+    float* texcoords_ = nullptr; // nullptr si le fichier n'a pas de vt
+    unsigned int* indices_ = nullptr;
+    size_t positionCount_ = 0;
+    size_t vertexCount_ = 0;
+    size_t indexCount_ = 0;
+    std::vector<ArenaMesh> meshes_;
+
+    friend struct ArenaIngest;
+};
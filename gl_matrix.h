@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+// Matrices 4x4 rangées colonne par colonne, comme celles d'OpenGL : les fonctions ci-dessous
+// reproduisent glLoadIdentity, glMultMatrixf, glTranslatef, glRotatef et gluPerspective pour les
+// chemins de rendu sur le processeur, qui doivent voir la scène exactement comme display().
+
+inline void matrixIdentity(float m[16]) {
+    static const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    std::memcpy(m, identity, sizeof(identity));
+}
+
+// m = m * b (b peut être m)
+inline void matrixMultiply(float m[16], const float b[16]) {
+    float result[16];
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            result[column * 4 + row] = m[row] * b[column * 4] + m[4 + row] * b[column * 4 + 1] +
+                                       m[8 + row] * b[column * 4 + 2] + m[12 + row] * b[column * 4 + 3];
+        }
+    }
+    std::memcpy(m, result, sizeof(result));
+}
+
+inline void matrixTranslate(float m[16], float x, float y, float z) {
+    float t[16];
+    matrixIdentity(t);
+    t[12] = x;
+    t[13] = y;
+    t[14] = z;
+    matrixMultiply(m, t);
+}
+
+// Rotation de `degrees` autour de l'axe (x, y, z), normalisé comme par glRotatef
+inline void matrixRotate(float m[16], float degrees, float x, float y, float z) {
+    const float length = std::sqrt(x * x + y * y + z * z);
+    if (length == 0.0f) {
+        return;
+    }
+    x /= length;
+    y /= length;
+    z /= length;
+    const float radians = degrees * 3.14159265358979f / 180.0f;
+    const float c = std::cos(radians), s = std::sin(radians), t = 1.0f - c;
+    const float r[16] = {x * x * t + c,     y * x * t + z * s, x * z * t - y * s, 0,
+                         x * y * t - z * s, y * y * t + c,     y * z * t + x * s, 0,
+                         x * z * t + y * s, y * z * t - x * s, z * z * t + c,     0,
+                         0,                 0,                 0,                 1};
+    matrixMultiply(m, r);
+}
+
+inline void matrixPerspective(float m[16], float fovyDegrees, float aspect, float zNear, float zFar) {
+    const float f = 1.0f / std::tan(fovyDegrees * 3.14159265358979f / 360.0f);
+    float p[16] = {};
+    p[0] = f / aspect;
+    p[5] = f;
+    p[10] = (zFar + zNear) / (zNear - zFar);
+    p[11] = -1.0f;
+    p[14] = 2.0f * zFar * zNear / (zNear - zFar);
+    matrixMultiply(m, p);
+}
+
+// Point (x, y, z, 1) transformé : out = m * p
+inline void matrixTransformPoint(const float m[16], const float p[3], float out[4]) {
+    for (int row = 0; row < 4; ++row) {
+        out[row] = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+    }
+}
+
+// Matrice des normales : transposée de l'inverse de la partie 3x3 de m (rangée colonne par colonne)
+inline void matrixNormal(const float m[16], float out[9]) {
+    const float a = m[0], b = m[4], c = m[8];
+    const float d = m[1], e = m[5], f = m[9];
+    const float g = m[2], h = m[6], i = m[10];
+    const float cofactor[9] = {e * i - f * h, f * g - d * i, d * h - e * g,
+                               c * h - b * i, a * i - c * g, b * g - a * h,
+                               b * f - c * e, c * d - a * f, a * e - b * d};
+    const float determinant = a * cofactor[0] + b * cofactor[1] + c * cofactor[2];
+    const float inverse = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+    // cofactor[ligne * 3 + colonne] est le cofacteur de l'élément (ligne, colonne) ;
+    // (M^-1)^T = cofacteurs / déterminant, rangés ici colonne par colonne
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            out[column * 3 + row] = cofactor[row * 3 + column] * inverse;
+        }
+    }
+}
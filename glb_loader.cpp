@@ -0,0 +1,632 @@
+#include "glb_loader.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "path_utils.h"
+
+namespace {
+
+const uint32_t kGlbMagic = 0x46546C67;     // "glTF"
+const uint32_t kChunkJson = 0x4E4F534A;    // "JSON"
+const uint32_t kChunkBin = 0x004E4942;     // "BIN\0"
+const int kModeTriangles = 4;
+
+const uint32_t kGlByte = 5120;
+const uint32_t kGlUnsignedByte = 5121;
+const uint32_t kGlShort = 5122;
+const uint32_t kGlUnsignedShort = 5123;
+const uint32_t kGlUnsignedInt = 5125;
+const uint32_t kGlFloat = 5126;
+
+// Arbre JSON minimal, suffisant pour l'en-tête glTF (quelques Ko à quelques Mo)
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object };
+    Type type = Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* find(const char* key) const {
+        for (const auto& member : object) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    const JsonValue* at(size_t i) const { return type == Array && i < array.size() ? &array[i] : nullptr; }
+
+    double numberOr(const char* key, double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Number ? value->number : fallback;
+    }
+
+    std::string stringOr(const char* key, const std::string& fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == String ? value->string : fallback;
+    }
+};
+
+class JsonParser {
+public:
+    JsonParser(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+    bool parse(JsonValue& value) {
+        if (!parseValue(value, 0)) {
+            return false;
+        }
+        skipSpaces();
+        return p_ == end_;
+    }
+
+private:
+    static const int kMaxDepth = 64;
+
+    void skipSpaces() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if (static_cast<size_t>(end_ - p_) < n || std::memcmp(p_, word, n) != 0) {
+            return false;
+        }
+        p_ += n;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& code) {
+        if (end_ - p_ < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= c - '0';
+            else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++p_; // guillemet ouvrant
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ != '\\') {
+                out += *p_++;
+                continue;
+            }
+            if (++p_ >= end_) {
+                return false;
+            }
+            char escape = *p_++;
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code;
+                    if (!parseHex4(code)) {
+                        return false;
+                    }
+                    // Paire de substitution UTF-16
+                    if (code >= 0xD800 && code < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                        p_ += 2;
+                        uint32_t low;
+                        if (!parseHex4(low)) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default: return false;
+            }
+        }
+        if (p_ >= end_) {
+            return false;
+        }
+        ++p_; // guillemet fermant
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipSpaces();
+        if (p_ >= end_ || depth > kMaxDepth) {
+            return false;
+        }
+        switch (*p_) {
+            case '{': {
+                value.type = JsonValue::Object;
+                ++p_;
+                skipSpaces();
+                if (p_ < end_ && *p_ == '}') {
+                    ++p_;
+                    return true;
+                }
+                for (;;) {
+                    skipSpaces();
+                    std::pair<std::string, JsonValue> member;
+                    if (p_ >= end_ || *p_ != '"' || !parseString(member.first)) {
+                        return false;
+                    }
+                    skipSpaces();
+                    if (p_ >= end_ || *p_++ != ':' || !parseValue(member.second, depth + 1)) {
+                        return false;
+                    }
+                    value.object.push_back(std::move(member));
+                    skipSpaces();
+                    if (p_ < end_ && *p_ == ',') {
+                        ++p_;
+                        continue;
+                    }
+                    return p_ < end_ && *p_++ == '}';
+                }
+            }
+            case '[': {
+                value.type = JsonValue::Array;
+                ++p_;
+                skipSpaces();
+                if (p_ < end_ && *p_ == ']') {
+                    ++p_;
+                    return true;
+                }
+                for (;;) {
+                    value.array.emplace_back();
+                    if (!parseValue(value.array.back(), depth + 1)) {
+                        return false;
+                    }
+                    skipSpaces();
+                    if (p_ < end_ && *p_ == ',') {
+                        ++p_;
+                        continue;
+                    }
+                    return p_ < end_ && *p_++ == ']';
+                }
+            }
+            case '"':
+                value.type = JsonValue::String;
+                return parseString(value.string);
+            case 't':
+                value.type = JsonValue::Bool;
+                value.boolean = true;
+                return literal("true");
+            case 'f':
+                value.type = JsonValue::Bool;
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default: {
+                // strtod s'arrête au premier caractère invalide ; le JSON est borné par le bloc
+                std::string token;
+                while (p_ < end_ && *p_ != '\0' && (std::strchr("+-.eE", *p_) || (*p_ >= '0' && *p_ <= '9'))) {
+                    token += *p_++;
+                }
+                char* stop = nullptr;
+                value.type = JsonValue::Number;
+                value.number = std::strtod(token.c_str(), &stop);
+                return !token.empty() && stop == token.c_str() + token.size();
+            }
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+void identity(float m[16]) {
+    for (int i = 0; i < 16; ++i) {
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+// out = a * b, matrices colonne par colonne
+void multiply(const float a[16], const float b[16], float out[16]) {
+    float result[16];
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                sum += a[k * 4 + row] * b[col * 4 + k];
+            }
+            result[col * 4 + row] = sum;
+        }
+    }
+    std::memcpy(out, result, sizeof(result));
+}
+
+// Transformation locale d'un noeud : `matrix`, sinon translation * rotation * échelle
+void nodeMatrix(const JsonValue& node, float m[16]) {
+    identity(m);
+    const JsonValue* matrix = node.find("matrix");
+    if (matrix && matrix->type == JsonValue::Array && matrix->array.size() == 16) {
+        for (int i = 0; i < 16; ++i) {
+            m[i] = static_cast<float>(matrix->array[i].number);
+        }
+        return;
+    }
+    float t[3] = {0.0f, 0.0f, 0.0f}, s[3] = {1.0f, 1.0f, 1.0f}, q[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    auto read = [&node](const char* key, float* out, size_t n) {
+        const JsonValue* value = node.find(key);
+        if (value && value->type == JsonValue::Array && value->array.size() == n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<float>(value->array[i].number);
+            }
+        }
+    };
+    read("translation", t, 3);
+    read("rotation", q, 4);
+    read("scale", s, 3);
+
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    const float r[9] = {1 - 2 * (y * y + z * z), 2 * (x * y + z * w),     2 * (x * z - y * w),
+                        2 * (x * y - z * w),     1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+                        2 * (x * z + y * w),     2 * (y * z - x * w),     1 - 2 * (x * x + y * y)};
+    for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < 3; ++row) {
+            m[col * 4 + row] = r[col * 3 + row] * s[col];
+        }
+        m[12 + col] = t[col];
+    }
+}
+
+size_t componentSize(uint32_t componentType) {
+    switch (componentType) {
+        case kGlByte:
+        case kGlUnsignedByte: return 1;
+        case kGlShort:
+        case kGlUnsignedShort: return 2;
+        case kGlUnsignedInt:
+        case kGlFloat: return 4;
+        default: return 0;
+    }
+}
+
+int typeComponents(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+class GlbReader {
+public:
+    GlbReader(const JsonValue& root, const unsigned char* bin, size_t binSize, std::vector<GlbPrimitive>& primitives)
+        : root_(root), bin_(bin), binSize_(binSize), primitives_(primitives) {}
+
+    bool read(std::string* err) {
+        const JsonValue* nodes = root_.find("nodes");
+        std::vector<size_t> roots;
+        const JsonValue* scenes = root_.find("scenes");
+        const JsonValue* scene = scenes ? scenes->at(static_cast<size_t>(root_.numberOr("scene", 0))) : nullptr;
+        const JsonValue* sceneNodes = scene ? scene->find("nodes") : nullptr;
+        if (sceneNodes && sceneNodes->type == JsonValue::Array) {
+            for (const JsonValue& index : sceneNodes->array) {
+                roots.push_back(static_cast<size_t>(index.number));
+            }
+        } else if (nodes && nodes->type == JsonValue::Array) {
+            // Pas de scène : tous les noeuds qui ne sont l'enfant d'aucun autre
+            std::vector<bool> isChild(nodes->array.size(), false);
+            for (const JsonValue& node : nodes->array) {
+                const JsonValue* children = node.find("children");
+                for (size_t c = 0; children && c < children->array.size(); ++c) {
+                    size_t child = static_cast<size_t>(children->array[c].number);
+                    if (child < isChild.size()) {
+                        isChild[child] = true;
+                    }
+                }
+            }
+            for (size_t i = 0; i < isChild.size(); ++i) {
+                if (!isChild[i]) {
+                    roots.push_back(i);
+                }
+            }
+        }
+
+        float world[16];
+        identity(world);
+        for (size_t node : roots) {
+            if (!visitNode(node, world, 0, err)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool visitNode(size_t index, const float parent[16], int depth, std::string* err) {
+        const JsonValue* nodes = root_.find("nodes");
+        const JsonValue* node = nodes ? nodes->at(index) : nullptr;
+        if (!node || depth > 256) {
+            if (err) *err = "hiérarchie de noeuds glTF invalide";
+            return false;
+        }
+        float local[16], world[16];
+        nodeMatrix(*node, local);
+        multiply(parent, local, world);
+
+        const JsonValue* meshIndex = node->find("mesh");
+        if (meshIndex && !addMesh(static_cast<size_t>(meshIndex->number), node->stringOr("name", ""), world, err)) {
+            return false;
+        }
+        const JsonValue* children = node->find("children");
+        for (size_t c = 0; children && c < children->array.size(); ++c) {
+            if (!visitNode(static_cast<size_t>(children->array[c].number), world, depth + 1, err)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool addMesh(size_t index, const std::string& nodeName, const float world[16], std::string* err) {
+        const JsonValue* meshes = root_.find("meshes");
+        const JsonValue* mesh = meshes ? meshes->at(index) : nullptr;
+        const JsonValue* primitives = mesh ? mesh->find("primitives") : nullptr;
+        if (!primitives || primitives->type != JsonValue::Array) {
+            if (err) *err = "mesh glTF " + std::to_string(index) + " invalide";
+            return false;
+        }
+        // Nom du noeud, sinon du mesh : un même mesh peut être placé par plusieurs noeuds
+        const std::string name = !nodeName.empty() ? nodeName : mesh->stringOr("name", "mesh" + std::to_string(index));
+
+        for (size_t p = 0; p < primitives->array.size(); ++p) {
+            const JsonValue& source = primitives->array[p];
+            if (source.numberOr("mode", kModeTriangles) != kModeTriangles) {
+                continue;
+            }
+            const JsonValue* attributes = source.find("attributes");
+            const JsonValue* position = attributes ? attributes->find("POSITION") : nullptr;
+            if (!position) {
+                continue;
+            }
+
+            GlbPrimitive primitive;
+            primitive.name = primitives->array.size() > 1 ? name + "#" + std::to_string(p) : name;
+            std::memcpy(primitive.transform, world, sizeof(primitive.transform));
+            MeshBounds local;
+            if (!resolveAccessor(*position, primitive.positions, &local, err) ||
+                !checkFormat(primitive.positions, 3, false, "POSITION", err)) {
+                return false;
+            }
+            const JsonValue* normal = attributes->find("NORMAL");
+            if (normal && (!resolveAccessor(*normal, primitive.normals, nullptr, err) ||
+                           !checkFormat(primitive.normals, 3, false, "NORMAL", err))) {
+                return false;
+            }
+            const JsonValue* texcoord = attributes->find("TEXCOORD_0");
+            if (texcoord && (!resolveAccessor(*texcoord, primitive.texcoords, nullptr, err) ||
+                             !checkFormat(primitive.texcoords, 2, false, "TEXCOORD_0", err))) {
+                return false;
+            }
+            const JsonValue* indices = source.find("indices");
+            if (indices && (!resolveAccessor(*indices, primitive.indices, nullptr, err) ||
+                            !checkFormat(primitive.indices, 1, true, "indices", err))) {
+                return false;
+            }
+            if (!checkIndices(primitive, err)) {
+                return false;
+            }
+            primitive.bounds = transformBounds(local, world);
+            primitives_.push_back(std::move(primitive));
+        }
+        return true;
+    }
+
+    bool resolveAccessor(const JsonValue& indexValue, GlbStream& stream, MeshBounds* bounds, std::string* err) {
+        const size_t index = static_cast<size_t>(indexValue.number);
+        const JsonValue* accessors = root_.find("accessors");
+        const JsonValue* accessor = accessors ? accessors->at(index) : nullptr;
+        const JsonValue* views = root_.find("bufferViews");
+        const JsonValue* viewIndex = accessor ? accessor->find("bufferView") : nullptr;
+        const JsonValue* view = views && viewIndex ? views->at(static_cast<size_t>(viewIndex->number)) : nullptr;
+        if (!accessor || !view || accessor->find("sparse")) {
+            if (err) *err = "accesseur glTF " + std::to_string(index) + " non pris en charge (absent, sans bufferView ou creux)";
+            return false;
+        }
+        const JsonValue* buffers = root_.find("buffers");
+        const size_t bufferIndex = static_cast<size_t>(view->numberOr("buffer", 0));
+        const JsonValue* buffer = buffers ? buffers->at(bufferIndex) : nullptr;
+        if (bufferIndex != 0 || !buffer || buffer->find("uri")) {
+            if (err) *err = "seul le bloc binaire du .glb est lu sans copie (buffer externe " + std::to_string(bufferIndex) + ")";
+            return false;
+        }
+
+        stream.componentType = static_cast<uint32_t>(accessor->numberOr("componentType", 0));
+        stream.components = typeComponents(accessor->stringOr("type", ""));
+        stream.count = static_cast<size_t>(accessor->numberOr("count", 0));
+        const size_t elementSize = componentSize(stream.componentType) * static_cast<size_t>(stream.components);
+        stream.stride = static_cast<size_t>(view->numberOr("byteStride", 0));
+        if (stream.stride == 0) {
+            stream.stride = elementSize;
+        }
+        const double viewOffset = view->numberOr("byteOffset", 0);
+        const double viewLength = view->numberOr("byteLength", 0);
+        const double accessorOffset = accessor->numberOr("byteOffset", 0);
+        const double lastByte = accessorOffset + (stream.count ? double(stream.count - 1) * stream.stride + elementSize : 0);
+        if (elementSize == 0 || stream.stride < elementSize || viewOffset < 0 || accessorOffset < 0 ||
+            lastByte > viewLength || viewOffset + viewLength > double(binSize_)) {
+            if (err) *err = "accesseur glTF " + std::to_string(index) + " hors du bloc binaire";
+            return false;
+        }
+        stream.data = bin_ + static_cast<size_t>(viewOffset + accessorOffset);
+
+        if (bounds) {
+            const JsonValue* min = accessor->find("min");
+            const JsonValue* max = accessor->find("max");
+            if (min && max && min->array.size() >= 3 && max->array.size() >= 3) {
+                for (int k = 0; k < 3; ++k) {
+                    bounds->min[k] = static_cast<float>(min->array[k].number);
+                    bounds->max[k] = static_cast<float>(max->array[k].number);
+                }
+            } else {
+                // min/max sont obligatoires pour POSITION, mais certains exporteurs les omettent
+                *bounds = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+                for (size_t i = 0; i < stream.count; ++i) {
+                    float p[3];
+                    std::memcpy(p, stream.data + i * stream.stride, sizeof(p));
+                    for (int k = 0; k < 3; ++k) {
+                        bounds->min[k] = std::min(bounds->min[k], p[k]);
+                        bounds->max[k] = std::max(bounds->max[k], p[k]);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Formats utilisables tels quels par glVertexPointer/glNormalPointer/glTexCoordPointer et glDrawElements
+    static bool checkFormat(const GlbStream& stream, int components, bool isIndex, const char* what, std::string* err) {
+        bool valid = isIndex ? (stream.components == 1 && (stream.componentType == kGlUnsignedByte ||
+                                                           stream.componentType == kGlUnsignedShort ||
+                                                           stream.componentType == kGlUnsignedInt) &&
+                                stream.stride == componentSize(stream.componentType))
+                             : (stream.components == components && stream.componentType == kGlFloat &&
+                                stream.stride % 4 == 0);
+        if (!valid) {
+            if (err) *err = std::string("format d'accesseur glTF non pris en charge pour ") + what +
+                            " (quantifié ou entrelacé d'indices)";
+        }
+        return valid;
+    }
+
+    // Les attributs doivent couvrir tous les sommets et les indices rester dans les limites
+    static bool checkIndices(const GlbPrimitive& primitive, std::string* err) {
+        const size_t vertices = primitive.positions.count;
+        if ((primitive.normals.data && primitive.normals.count < vertices) ||
+            (primitive.texcoords.data && primitive.texcoords.count < vertices)) {
+            if (err) *err = "attributs glTF incomplets pour " + primitive.name;
+            return false;
+        }
+        const GlbStream& indices = primitive.indices;
+        for (size_t i = 0; i < indices.count; ++i) {
+            const unsigned char* p = indices.data + i * indices.stride;
+            uint32_t value;
+            if (indices.componentType == kGlUnsignedByte) {
+                value = *p;
+            } else if (indices.componentType == kGlUnsignedShort) {
+                uint16_t v16;
+                std::memcpy(&v16, p, sizeof(v16));
+                value = v16;
+            } else {
+                std::memcpy(&value, p, sizeof(value));
+            }
+            if (value >= vertices) {
+                if (err) *err = "indice glTF hors limites dans " + primitive.name;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static MeshBounds transformBounds(const MeshBounds& local, const float m[16]) {
+        MeshBounds result = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+        for (int corner = 0; corner < 8; ++corner) {
+            const float p[3] = {(corner & 1) ? local.max[0] : local.min[0], (corner & 2) ? local.max[1] : local.min[1],
+                                (corner & 4) ? local.max[2] : local.min[2]};
+            for (int k = 0; k < 3; ++k) {
+                float value = m[k] * p[0] + m[4 + k] * p[1] + m[8 + k] * p[2] + m[12 + k];
+                result.min[k] = std::min(result.min[k], value);
+                result.max[k] = std::max(result.max[k], value);
+            }
+        }
+        return result;
+    }
+
+    const JsonValue& root_;
+    const unsigned char* bin_;
+    size_t binSize_;
+    std::vector<GlbPrimitive>& primitives_;
+};
+
+uint32_t readU32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+bool isGlbPath(const std::string& path) {
+    return hasExtension(path, ".glb");
+}
+
+bool GlbModel::open(const std::string& path, std::string* err) {
+    primitives_.clear();
+    if (!file_.open(path, err)) {
+        return false;
+    }
+
+    // En-tête de 12 octets puis blocs (longueur, type, données) alignés sur 4 octets
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    if (size < 20 || readU32(data) != kGlbMagic || readU32(data + 4) != 2) {
+        if (err) *err = "fichier GLB 2.0 invalide : " + path;
+        return false;
+    }
+    const size_t jsonLength = readU32(data + 12);
+    if (readU32(data + 16) != kChunkJson || jsonLength > size - 20) {
+        if (err) *err = "bloc JSON du GLB invalide : " + path;
+        return false;
+    }
+    const unsigned char* bin = nullptr;
+    size_t binSize = 0;
+    const size_t binHeader = 20 + jsonLength;
+    if (size - binHeader >= 8 && readU32(data + binHeader + 4) == kChunkBin) {
+        binSize = readU32(data + binHeader);
+        if (binSize > size - binHeader - 8) {
+            if (err) *err = "bloc binaire du GLB tronqué : " + path;
+            return false;
+        }
+        bin = reinterpret_cast<const unsigned char*>(data + binHeader + 8);
+    }
+
+    JsonValue root;
+    JsonParser parser(data + 20, data + 20 + jsonLength);
+    if (!parser.parse(root) || root.type != JsonValue::Object) {
+        if (err) *err = "JSON du GLB invalide : " + path;
+        return false;
+    }
+    GlbReader reader(root, bin, binSize, primitives_);
+    if (!reader.read(err)) {
+        primitives_.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "mesh_view.h"
+
+// Flux d'attribut ou d'indices d'un accesseur glTF, pointant directement dans le bloc binaire projeté
+struct GlbStream {
+    const unsigned char* data = nullptr; // nullptr si absent
+    size_t count = 0;
+    size_t stride = 0;           // octets entre deux éléments
+    uint32_t componentType = 0;  // constante GL (GL_FLOAT, GL_UNSIGNED_SHORT...)
+    int components = 0;
+};
+
+// Primitive triangulée d'un mesh glTF, placée dans la scène par la transformation de son noeud
+struct GlbPrimitive {
+    std::string name;
+    GlbStream positions;
+    GlbStream normals;
+    GlbStream texcoords; // TEXCOORD_0, déjà dans la convention de aiProcess_FlipUVs
+    GlbStream indices;   // absent : sommets dessinés dans l'ordre
+    float transform[16]; // monde, colonne par colonne (comme glMultMatrixf)
+    MeshBounds bounds;   // boîte englobante en coordonnées monde, d'après min/max de POSITION
+};
+
+// Chargeur .glb natif sans copie : le fichier est projeté en mémoire, seul le JSON est analysé,
+// et les accesseurs des primitives pointent dans le bloc BIN (positions et normales en flottants,
+// uv en flottants, indices 8/16/32 bits). Seules les primitives TRIANGLES sont retenues.
+class GlbModel {
+public:
+    bool open(const std::string& path, std::string* err);
+
+    const std::vector<GlbPrimitive>& primitives() const { return primitives_; }
+    size_t bytes() const { return file_.size(); }
+
+private:
+    MappedFile file_;
+    std::vector<GlbPrimitive> primitives_;
+};
+
+// Vrai si le chemin désigne un fichier .glb
+bool isGlbPath(const std::string& path);
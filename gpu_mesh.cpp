@@ -0,0 +1,248 @@
+#include "gpu_mesh.h"
+#include "compact_mesh.h"
+#include "glb_loader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Décalage dans le tampon lié, sous la forme de pointeur attendue par les fonctions gl*Pointer
+const void* bufferOffset(size_t offset) {
+    return reinterpret_cast<const void*>(offset);
+}
+
+GLuint uploadIndices(const void* data, size_t bytes) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+// Octets couverts par un flux glTF de flottants, du premier élément à la fin du dernier
+size_t streamSpan(const GlbStream& stream) {
+    return stream.count ? (stream.count - 1) * stream.stride + size_t(stream.components) * sizeof(float) : 0;
+}
+
+} // namespace
+
+GpuMesh uploadMesh(const MeshView& mesh) {
+    GpuMesh gpu;
+    const size_t positionBytes = mesh.vertexCount * 3 * sizeof(float);
+    const size_t normalBytes = mesh.normals ? mesh.vertexCount * 3 * sizeof(float) : 0;
+    const size_t texcoordBytes = mesh.texcoords ? mesh.vertexCount * 2 * sizeof(float) : 0;
+    const size_t indexBytes = mesh.indexCount * sizeof(unsigned int);
+    gpu.positions.type = GL_FLOAT;
+    if (mesh.normals) {
+        gpu.normals.type = GL_FLOAT;
+        gpu.normals.offset = positionBytes;
+    }
+    if (mesh.texcoords) {
+        gpu.texcoords.type = GL_FLOAT;
+        gpu.texcoords.offset = positionBytes + normalBytes;
+    }
+    gpu.indexCount = static_cast<GLsizei>(mesh.indexCount);
+    gpu.vertexCount = static_cast<GLsizei>(mesh.vertexCount);
+    gpu.byteSize = positionBytes + normalBytes + texcoordBytes + indexBytes;
+
+    // Allocation puis remplissage par parties : les attributs restent dans leurs tableaux d'origine
+    glGenBuffers(1, &gpu.vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(positionBytes + normalBytes + texcoordBytes), nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(positionBytes), mesh.positions);
+    if (normalBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(gpu.normals.offset), static_cast<GLsizeiptr>(normalBytes), mesh.normals);
+    }
+    if (texcoordBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(gpu.texcoords.offset), static_cast<GLsizeiptr>(texcoordBytes),
+                        mesh.texcoords);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    gpu.indexBuffer = uploadIndices(mesh.indices, indexBytes);
+    return gpu;
+}
+
+GpuMesh uploadCompactMesh(const CompactMesh& mesh) {
+    GpuMesh gpu;
+    const size_t count = mesh.vertices.size();
+
+    // Grille uniforme du plus grand côté : exacte sur cet axe, les autres sont requantifiés au même pas.
+    // Valeurs centrées sur 0 pour tenir dans GL_SHORT, seul type entier de glVertexPointer.
+    float step = std::max({mesh.scale[0], mesh.scale[1], mesh.scale[2]});
+    if (step <= 0.0f) {
+        step = 1.0f; // tous les sommets confondus
+    }
+    std::vector<int16_t> positions(count * 3);
+    for (size_t v = 0; v < count; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            const long q = std::lround(mesh.vertices[v].position[k] * (mesh.scale[k] / step));
+            positions[v * 3 + k] = static_cast<int16_t>(std::min(q, 65535L) - 32768);
+        }
+    }
+    gpu.quantizedPositions = true;
+    gpu.positionScale = step;
+    for (int k = 0; k < 3; ++k) {
+        gpu.positionOffset[k] = mesh.bounds.min[k] + 32768.0f * step;
+    }
+
+    std::vector<int16_t> normals(mesh.hasNormals ? count * 3 : 0);
+    std::vector<float> texcoords(mesh.hasTexcoords ? count * 2 : 0);
+    for (unsigned int v = 0; v < count; ++v) {
+        if (mesh.hasNormals) {
+            float normal[3];
+            mesh.decodeNormal(v, normal);
+            for (int k = 0; k < 3; ++k) {
+                normals[size_t(v) * 3 + k] = static_cast<int16_t>(std::lround(std::clamp(normal[k], -1.0f, 1.0f) * 32767.0f));
+            }
+        }
+        if (mesh.hasTexcoords) {
+            mesh.decodeTexcoord(v, &texcoords[size_t(v) * 2]);
+        }
+    }
+
+    const size_t positionBytes = positions.size() * sizeof(int16_t);
+    const size_t normalBytes = normals.size() * sizeof(int16_t);
+    const size_t texcoordBytes = texcoords.size() * sizeof(float);
+    gpu.positions.type = GL_SHORT;
+    if (mesh.hasNormals) {
+        gpu.normals.type = GL_SHORT;
+        gpu.normals.offset = positionBytes;
+    }
+    if (mesh.hasTexcoords) {
+        gpu.texcoords.type = GL_FLOAT;
+        gpu.texcoords.offset = (positionBytes + normalBytes + 3) & ~size_t(3);
+    }
+    const size_t vertexBytes = gpu.texcoords.type ? gpu.texcoords.offset + texcoordBytes : positionBytes + normalBytes;
+
+    glGenBuffers(1, &gpu.vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexBytes), nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(positionBytes), positions.data());
+    if (normalBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(gpu.normals.offset), static_cast<GLsizeiptr>(normalBytes),
+                        normals.data());
+    }
+    if (texcoordBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(gpu.texcoords.offset), static_cast<GLsizeiptr>(texcoordBytes),
+                        texcoords.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    size_t indexBytes;
+    if (count <= 65536) {
+        std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        indexBytes = shortIndices.size() * sizeof(uint16_t);
+        gpu.indexType = GL_UNSIGNED_SHORT;
+        gpu.indexBuffer = uploadIndices(shortIndices.data(), indexBytes);
+    } else {
+        indexBytes = mesh.indices.size() * sizeof(unsigned int);
+        gpu.indexBuffer = uploadIndices(mesh.indices.data(), indexBytes);
+    }
+    gpu.indexCount = static_cast<GLsizei>(mesh.indices.size());
+    gpu.vertexCount = static_cast<GLsizei>(count);
+    gpu.byteSize = vertexBytes + indexBytes;
+    return gpu;
+}
+
+GpuMesh uploadGlbPrimitive(const GlbPrimitive& primitive) {
+    GpuMesh gpu;
+    const GlbStream* streams[3] = {&primitive.positions, &primitive.normals, &primitive.texcoords};
+    GpuAttribute* attributes[3] = {&gpu.positions, &gpu.normals, &gpu.texcoords};
+
+    // Plages chevauchantes (attributs entrelacés dans une même vue) : leur union est déposée d'un bloc
+    const unsigned char* first = nullptr;
+    const unsigned char* last = nullptr;
+    size_t spans = 0;
+    for (const GlbStream* stream : streams) {
+        if (stream->data && stream->count > 0) {
+            const unsigned char* end = stream->data + streamSpan(*stream);
+            first = first ? std::min(first, stream->data) : stream->data;
+            last = last ? std::max(last, end) : end;
+            spans += streamSpan(*stream);
+        }
+    }
+    const bool together = first && size_t(last - first) <= spans;
+    const size_t vertexBytes = together ? size_t(last - first) : spans;
+
+    glGenBuffers(1, &gpu.vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexBytes), together ? first : nullptr, GL_STATIC_DRAW);
+    size_t offset = 0;
+    for (int a = 0; a < 3; ++a) {
+        const GlbStream& stream = *streams[a];
+        if (!stream.data || stream.count == 0) {
+            continue;
+        }
+        attributes[a]->type = GL_FLOAT;
+        attributes[a]->stride = static_cast<GLsizei>(stream.stride);
+        if (together) {
+            attributes[a]->offset = size_t(stream.data - first);
+        } else {
+            attributes[a]->offset = offset;
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(streamSpan(stream)), stream.data);
+            offset += streamSpan(stream);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    size_t indexBytes = 0;
+    if (primitive.indices.data) {
+        indexBytes = primitive.indices.count * primitive.indices.stride; // pas égal à la taille d'un indice
+        gpu.indexType = primitive.indices.componentType;
+        gpu.indexBuffer = uploadIndices(primitive.indices.data, indexBytes);
+        gpu.indexCount = static_cast<GLsizei>(primitive.indices.count);
+    }
+    gpu.vertexCount = static_cast<GLsizei>(primitive.positions.count);
+    gpu.byteSize = vertexBytes + indexBytes;
+    return gpu;
+}
+
+void drawGpuMesh(const GpuMesh& mesh, bool withAttributes) {
+    if (mesh.quantizedPositions) {
+        glPushMatrix();
+        glTranslatef(mesh.positionOffset[0], mesh.positionOffset[1], mesh.positionOffset[2]);
+        glScalef(mesh.positionScale, mesh.positionScale, mesh.positionScale);
+        glEnable(GL_RESCALE_NORMAL);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, mesh.positions.type, mesh.positions.stride, bufferOffset(mesh.positions.offset));
+    if (withAttributes && mesh.normals.type) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(mesh.normals.type, mesh.normals.stride, bufferOffset(mesh.normals.offset));
+    }
+    if (withAttributes && mesh.texcoords.type) {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, mesh.texcoords.type, mesh.texcoords.stride, bufferOffset(mesh.texcoords.offset));
+    }
+    if (mesh.indexBuffer) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+        glDrawElements(GL_TRIANGLES, mesh.indexCount, mesh.indexType, bufferOffset(0));
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
+    }
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (mesh.quantizedPositions) {
+        glDisable(GL_RESCALE_NORMAL);
+        glPopMatrix();
+    }
+}
+
+void releaseGpuMesh(GpuMesh& mesh) {
+    if (mesh.vertexBuffer) {
+        glDeleteBuffers(1, &mesh.vertexBuffer);
+    }
+    if (mesh.indexBuffer) {
+        glDeleteBuffers(1, &mesh.indexBuffer);
+    }
+    mesh = GpuMesh();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+#include "mesh_view.h"
+
+struct CompactMesh;
+struct GlbPrimitive;
+
+// Attribut de sommet dans le tampon, au format attendu par gl*Pointer ; type 0 si absent
+struct GpuAttribute {
+    GLenum type = 0;
+    GLsizei stride = 0;
+    size_t offset = 0; // en octets dans vertexBuffer
+};
+
+// Mesh déposé une fois pour toutes dans la mémoire du GPU : un tampon de sommets et un tampon d'indices,
+// dessinés par glDrawElements (glDrawArrays sans indices). Chaque attribut garde son propre format :
+// flottants non entrelacés pour les meshes ordinaires, entiers 16 bits pour les meshes compacts, plages
+// du .glb recopiées telles quelles avec leur pas. Nécessite un contexte OpenGL courant et les fonctions
+// chargées par glad (OpenGL 1.5).
+struct GpuMesh {
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0; // 0 : sommets dessinés dans l'ordre
+    GLsizei indexCount = 0;
+    GLsizei vertexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    GpuAttribute positions;
+    GpuAttribute normals;
+    GpuAttribute texcoords;
+    // Positions quantifiées : sommet = positionOffset + positionScale * valeur (échelle uniforme, pour que
+    // GL_RESCALE_NORMAL rende aux normales leur longueur)
+    bool quantizedPositions = false;
+    float positionOffset[3] = {0.0f, 0.0f, 0.0f};
+    float positionScale = 1.0f;
+    size_t byteSize = 0;
+};
+
+GpuMesh uploadMesh(const MeshView& mesh);
+
+// Positions requantifiées sur une grille uniforme de 16 bits (celle du plus grand côté de la boîte),
+// normales décodées en entiers 16 bits, uv en flottants : 12 octets par sommet sans uv au lieu de 24,
+// et indices 16 bits quand le mesh a au plus 65536 sommets
+GpuMesh uploadCompactMesh(const CompactMesh& mesh);
+
+// Plages des attributs copiées directement depuis le fichier projeté (une seule fois si elles se
+// chevauchent, comme des attributs entrelacés), indices 8/16/32 bits gardés. La transformation du
+// noeud reste à appliquer par l'appelant.
+GpuMesh uploadGlbPrimitive(const GlbPrimitive& primitive);
+
+void drawGpuMesh(const GpuMesh& mesh, bool withAttributes);
+
+// Supprime les tampons ; le mesh redevient vide
+void releaseGpuMesh(GpuMesh& mesh);
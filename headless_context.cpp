@@ -0,0 +1,238 @@
+#include "headless_context.h"
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__) && !defined(EGL_PLATFORM_SURFACELESS_MESA)
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace {
+
+#ifdef __linux__
+// Plateforme sans affichage si l'extension est présente, sinon l'affichage par défaut
+EGLDisplay openDisplay() {
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (extensions && std::strstr(extensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+GLADloadproc eglLoader() {
+    return reinterpret_cast<GLADloadproc>(eglGetProcAddress);
+}
+#endif
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Bloc PNG : longueur, type, données, CRC du type et des données
+void appendChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    appendBigEndian(out, static_cast<uint32_t>(data.size()));
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBigEndian(out, crc32(&out[start], out.size() - start));
+}
+
+} // namespace
+
+HeadlessContext::~HeadlessContext() {
+    destroy();
+}
+
+#ifndef __linux__
+bool HeadlessContext::create(int, int, std::string* err) {
+    if (err) *err = "rendu hors écran OpenGL non disponible sur cette plateforme (EGL, Linux uniquement) ; utiliser --software";
+    return false;
+}
+
+void HeadlessContext::destroy() {
+    display_ = nullptr;
+    context_ = nullptr;
+    framebuffer_ = colorBuffer_ = depthBuffer_ = 0;
+    width_ = height_ = 0;
+}
+#else
+bool HeadlessContext::create(int width, int height, std::string* err) {
+    destroy();
+    EGLDisplay display = openDisplay();
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        if (err) *err = "initialisation EGL impossible";
+        return false;
+    }
+    display_ = display;
+
+    // Aucune surface : le contexte est rendu courant seul (EGL_KHR_surfaceless_context)
+    const EGLint configAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(display, configAttributes, &config, 1, &configCount) ||
+        configCount == 0) {
+        if (err) *err = "aucune configuration EGL pour OpenGL";
+        destroy();
+        return false;
+    }
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if (context == EGL_NO_CONTEXT) {
+        if (err) *err = "création du contexte EGL impossible";
+        destroy();
+        return false;
+    }
+    context_ = context;
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        if (err) *err = "contexte EGL sans surface non pris en charge";
+        destroy();
+        return false;
+    }
+    if (!gladLoadGLLoader(eglLoader()) || !GLAD_GL_VERSION_3_0) {
+        if (err) *err = "OpenGL 3.0 indisponible (framebuffers hors écran)";
+        destroy();
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    glGenRenderbuffers(1, &colorBuffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer_);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        if (err) *err = "framebuffer hors écran incomplet";
+        destroy();
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (context_) {
+        if (framebuffer_) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer_);
+        }
+        if (colorBuffer_) {
+            glDeleteRenderbuffers(1, &colorBuffer_);
+        }
+        if (depthBuffer_) {
+            glDeleteRenderbuffers(1, &depthBuffer_);
+        }
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display_, context_);
+    }
+    if (display_) {
+        eglTerminate(display_);
+    }
+    display_ = nullptr;
+    context_ = nullptr;
+    framebuffer_ = colorBuffer_ = depthBuffer_ = 0;
+    width_ = height_ = 0;
+}
+#endif
+
+void HeadlessContext::readPixels(std::vector<uint8_t>& rgb) const {
+    const size_t rowBytes = size_t(width_) * 3;
+    std::vector<uint8_t> bottomUp(rowBytes * height_);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width_, height_, GL_RGB, GL_UNSIGNED_BYTE, bottomUp.data());
+    rgb.resize(bottomUp.size());
+    for (int y = 0; y < height_; ++y) {
+        std::memcpy(&rgb[size_t(y) * rowBytes], &bottomUp[size_t(height_ - 1 - y) * rowBytes], rowBytes);
+    }
+}
+
+bool writePpm(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb, std::string* err) {
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+    if (!out) {
+        if (err) *err = "écriture impossible : " + path;
+        return false;
+    }
+    return true;
+}
+
+bool writePng(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb, std::string* err) {
+    // Lignes précédées de leur filtre (0 : aucun)
+    const size_t rowBytes = size_t(width) * 3;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb.begin() + size_t(y) * rowBytes, rgb.begin() + size_t(y + 1) * rowBytes);
+    }
+
+    // Flux zlib : en-tête, blocs stockés d'au plus 65535 octets, somme Adler-32
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    for (size_t offset = 0; offset < raw.size(); offset += 65535) {
+        const size_t length = std::min<size_t>(65535, raw.size() - offset);
+        zlib.push_back(offset + length >= raw.size() ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(length));
+        zlib.push_back(static_cast<uint8_t>(length >> 8));
+        zlib.push_back(static_cast<uint8_t>(~length));
+        zlib.push_back(static_cast<uint8_t>(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+    }
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> header;
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bits, RGB, deflate, filtres standard, sans entrelacement
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", zlib);
+    appendChunk(png, "IEND", std::vector<uint8_t>());
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    if (!out) {
+        if (err) *err = "écriture impossible : " + path;
+        return false;
+    }
+    return true;
+}
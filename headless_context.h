@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Contexte OpenGL sans fenêtre ni serveur d'affichage (EGL, plateforme « surfaceless » de Mesa, donc
+// llvmpipe sur une machine sans GPU) : le rendu se fait dans un framebuffer hors écran de taille fixe
+// (couleur RGBA8, profondeur 24 bits). Les fonctions OpenGL sont chargées par glad à la création.
+// Linux uniquement : ailleurs, create() échoue et seul le rendu logiciel (--software) est disponible.
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    bool create(int width, int height, std::string* err);
+    void destroy();
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // Pixels RGB du framebuffer, première ligne en haut
+    void readPixels(std::vector<uint8_t>& rgb) const;
+
+private:
+    void* display_ = nullptr; // EGLDisplay
+    void* context_ = nullptr; // EGLContext
+    GLuint framebuffer_ = 0;
+    GLuint colorBuffer_ = 0;
+    GLuint depthBuffer_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+};
+
+// Image RGB 8 bits au format PPM binaire (P6)
+bool writePpm(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb, std::string* err);
+
+// Image RGB 8 bits au format PNG, sans compression (blocs deflate « stockés », pas de dépendance à zlib)
+bool writePng(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb, std::string* err);
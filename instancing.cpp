@@ -0,0 +1,301 @@
+#include "instancing.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Forme canonique d'un mesh : origine au centre de gravité des sommets et moments d'inertie
+// principaux (décroissants), qui ne dépendent ni de la position ni de l'orientation
+struct CanonicalFrame {
+    double center[3];
+    double moments[3];
+    double diameter;
+    double tolerance;
+    uint64_t hash;
+};
+
+// Valeurs et vecteurs propres (en colonnes) d'une matrice symétrique N x N (méthode de Jacobi)
+template <int N>
+void symmetricEigen(double a[N][N], double vectors[N][N], double values[N]) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            vectors[i][j] = i == j ? 1.0 : 0.0;
+        }
+    }
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double offDiagonal = 0.0;
+        for (int p = 0; p < N; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                offDiagonal += std::fabs(a[p][q]);
+            }
+        }
+        if (offDiagonal < 1e-30) {
+            break;
+        }
+        for (int p = 0; p < N - 1; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                if (std::fabs(a[p][q]) < 1e-300) {
+                    continue;
+                }
+                const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (int k = 0; k < N; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < N; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < N; ++k) {
+                    const double vkp = vectors[k][p], vkq = vectors[k][q];
+                    vectors[k][p] = c * vkp - s * vkq;
+                    vectors[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < N; ++i) {
+        values[i] = a[i][i];
+    }
+}
+
+uint64_t mixHash(uint64_t h, uint64_t value) {
+    h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+CanonicalFrame computeFrame(const MeshView& mesh, float relativeTolerance) {
+    CanonicalFrame frame = {};
+    const size_t n = mesh.vertexCount;
+    for (size_t v = 0; v < n; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            frame.center[k] += mesh.positions[v * 3 + k];
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        frame.center[k] /= static_cast<double>(std::max<size_t>(n, 1));
+    }
+
+    double covariance[3][3] = {};
+    for (size_t v = 0; v < n; ++v) {
+        double d[3];
+        for (int k = 0; k < 3; ++k) {
+            d[k] = mesh.positions[v * 3 + k] - frame.center[k];
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                covariance[i][j] += d[i] * d[j];
+            }
+        }
+    }
+    double vectors[3][3], values[3];
+    symmetricEigen<3>(covariance, vectors, values);
+    std::sort(values, values + 3, [](double a, double b) { return a > b; });
+    for (int c = 0; c < 3; ++c) {
+        frame.moments[c] = values[c] / static_cast<double>(std::max<size_t>(n, 1));
+    }
+
+    // Échelle invariante par rotation (contrairement à la boîte englobante) : distance maximale au centre
+    double radiusSquared = 0.0;
+    for (size_t v = 0; v < n; ++v) {
+        double distance = 0.0;
+        for (int k = 0; k < 3; ++k) {
+            const double d = mesh.positions[v * 3 + k] - frame.center[k];
+            distance += d * d;
+        }
+        radiusSquared = std::max(radiusSquared, distance);
+    }
+    frame.diameter = 2.0 * std::sqrt(radiusSquared);
+    frame.tolerance = std::max(frame.diameter * relativeTolerance, 1e-9);
+
+    // Empreinte : topologie exacte seulement. Les moments, qui varient continûment avec les positions,
+    // sont comparés avec une tolérance dans le groupe (un arrondi les séparerait de part et d'autre d'un palier)
+    uint64_t h = mixHash(n, mesh.indexCount);
+    h = mixHash(h, (mesh.normals ? 1u : 0u) | (mesh.texcoords ? 2u : 0u));
+    for (size_t i = 0; i < mesh.indexCount; ++i) {
+        h = mixHash(h, mesh.indices[i]);
+    }
+    frame.hash = h;
+    return frame;
+}
+
+// Filtre rapide avant la comparaison sommet par sommet : déplacer chaque sommet d'au plus la tolérance
+// change un moment (carré moyen des distances au centre) d'au plus ~ diamètre * tolérance
+bool momentsClose(const CanonicalFrame& a, const CanonicalFrame& b) {
+    const double tolerance = std::max(a.tolerance, b.tolerance);
+    const double allowed = 4.0 * tolerance * std::max(a.diameter, b.diameter) + tolerance * tolerance;
+    for (int c = 0; c < 3; ++c) {
+        if (std::fabs(a.moments[c] - b.moments[c]) > allowed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Vérifie sommet par sommet que le mesh b est l'image du mesh a par x -> rotation * x + translation
+bool matches(const MeshView& a, const MeshView& b, const double rotation[3][3], const double translation[3],
+             double tolerance) {
+    const double toleranceSquared = tolerance * tolerance;
+    for (size_t v = 0; v < a.vertexCount; ++v) {
+        const float* p = a.positions + v * 3;
+        const float* q = b.positions + v * 3;
+        double distance = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double mapped = rotation[r][0] * p[0] + rotation[r][1] * p[1] + rotation[r][2] * p[2] + translation[r];
+            distance += (mapped - q[r]) * (mapped - q[r]);
+        }
+        if (distance > toleranceSquared) {
+            return false;
+        }
+        if (a.normals) {
+            const float* n = a.normals + v * 3;
+            const float* m = b.normals + v * 3;
+            for (int r = 0; r < 3; ++r) {
+                const double mapped = rotation[r][0] * n[0] + rotation[r][1] * n[1] + rotation[r][2] * n[2];
+                if (std::fabs(mapped - m[r]) > 1e-3) {
+                    return false;
+                }
+            }
+        }
+        if (a.texcoords) {
+            if (std::fabs(a.texcoords[v * 2] - b.texcoords[v * 2]) > 1e-5f ||
+                std::fabs(a.texcoords[v * 2 + 1] - b.texcoords[v * 2 + 1]) > 1e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Cherche la transformation rigide de a vers b : translation seule d'abord (copies déplacées),
+// sinon rotation optimale au sens des moindres carrés entre sommets correspondants (méthode de Horn :
+// quaternion propre de plus grande valeur propre), valable aussi pour les formes symétriques
+bool findTransform(const MeshView& a, const CanonicalFrame& fa, const MeshView& b, const CanonicalFrame& fb,
+                   double rotation[3][3], double translation[3]) {
+    const double tolerance = std::max(fa.tolerance, fb.tolerance);
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            rotation[r][c] = r == c ? 1.0 : 0.0;
+        }
+        translation[r] = fb.center[r] - fa.center[r];
+    }
+    if (matches(a, b, rotation, translation, tolerance)) {
+        return true;
+    }
+
+    double s[3][3] = {};
+    for (size_t v = 0; v < a.vertexCount; ++v) {
+        for (int i = 0; i < 3; ++i) {
+            const double pa = a.positions[v * 3 + i] - fa.center[i];
+            for (int j = 0; j < 3; ++j) {
+                s[i][j] += pa * (b.positions[v * 3 + j] - fb.center[j]);
+            }
+        }
+    }
+    double n[4][4] = {
+        {s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1], s[2][0] - s[0][2], s[0][1] - s[1][0]},
+        {s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2], s[0][1] + s[1][0], s[2][0] + s[0][2]},
+        {s[2][0] - s[0][2], s[0][1] + s[1][0], -s[0][0] + s[1][1] - s[2][2], s[1][2] + s[2][1]},
+        {s[0][1] - s[1][0], s[2][0] + s[0][2], s[1][2] + s[2][1], -s[0][0] - s[1][1] + s[2][2]}};
+    double vectors[4][4], values[4];
+    symmetricEigen<4>(n, vectors, values);
+    const int best = static_cast<int>(std::max_element(values, values + 4) - values);
+    const double w = vectors[0][best], x = vectors[1][best], y = vectors[2][best], z = vectors[3][best];
+
+    const double quaternionRotation[3][3] = {
+        {w * w + x * x - y * y - z * z, 2 * (x * y - w * z), 2 * (x * z + w * y)},
+        {2 * (x * y + w * z), w * w - x * x + y * y - z * z, 2 * (y * z - w * x)},
+        {2 * (x * z - w * y), 2 * (y * z + w * x), w * w - x * x - y * y + z * z}};
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            rotation[r][c] = quaternionRotation[r][c];
+        }
+        translation[r] = fb.center[r] - (rotation[r][0] * fa.center[0] + rotation[r][1] * fa.center[1] +
+                                         rotation[r][2] * fa.center[2]);
+    }
+    return matches(a, b, rotation, translation, tolerance);
+}
+
+void setTransform(MeshInstance& instance, const double rotation[3][3], const double translation[3]) {
+    std::memset(instance.transform, 0, sizeof(instance.transform));
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            instance.transform[c * 4 + r] = static_cast<float>(rotation[r][c]);
+        }
+        instance.transform[12 + r] = static_cast<float>(translation[r]);
+    }
+    instance.transform[15] = 1.0f;
+}
+
+} // namespace
+
+std::vector<MeshInstance> findInstances(const std::vector<MeshView>& meshes, const InstancingOptions& options,
+                                        InstancingStats* stats) {
+    std::vector<CanonicalFrame> frames(meshes.size());
+    parallelFor(meshes.size(), [&](size_t i) {
+        frames[i] = computeFrame(meshes[i], options.tolerance);
+    }, options.numThreads);
+
+    std::vector<MeshInstance> instances(meshes.size());
+    const double identity[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    const double zero[3] = {0, 0, 0};
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        instances[i].prototype = i;
+        setTransform(instances[i], identity, zero);
+    }
+
+    // Groupes de même topologie, chacun traité indépendamment
+    std::unordered_map<uint64_t, std::vector<size_t>> groups;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        if (meshes[i].vertexCount > 0) {
+            groups[frames[i].hash].push_back(i);
+        }
+    }
+    std::vector<const std::vector<size_t>*> candidates;
+    for (const auto& group : groups) {
+        if (group.second.size() > 1) {
+            candidates.push_back(&group.second);
+        }
+    }
+    parallelFor(candidates.size(), [&](size_t g) {
+        std::vector<size_t> prototypes;
+        for (size_t i : *candidates[g]) {
+            bool found = false;
+            for (size_t p : prototypes) {
+                double rotation[3][3], translation[3];
+                if (momentsClose(frames[p], frames[i]) && findTransform(meshes[p], frames[p], meshes[i], frames[i], rotation, translation)) {
+                    instances[i].prototype = p;
+                    setTransform(instances[i], rotation, translation);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                prototypes.push_back(i);
+            }
+        }
+    }, options.numThreads);
+
+    if (stats) {
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            stats->verticesBefore += meshes[i].vertexCount;
+            if (instances[i].prototype == i) {
+                ++stats->prototypes;
+                stats->verticesAfter += meshes[i].vertexCount;
+            } else {
+                ++stats->instances;
+            }
+        }
+    }
+    return instances;
+}
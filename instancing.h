@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mesh_view.h"
+
+// Détection des meshes identiques à un déplacement rigide près (rotation + translation),
+// pour ne garder qu'une géométrie et une transformation par copie.
+struct MeshInstance {
+    size_t prototype;  // indice du mesh dont la géométrie est réutilisée (lui-même s'il est unique)
+    float transform[16]; // matrice 4x4 par colonnes (glMultMatrixf) : positions du prototype -> ce mesh
+};
+
+struct InstancingOptions {
+    float tolerance = 1e-4f; // écart toléré sur les positions, relatif au diamètre du mesh
+    unsigned int numThreads = 0;
+};
+
+struct InstancingStats {
+    size_t prototypes = 0; // géométries gardées, y compris les meshes sans copie
+    size_t instances = 0; // meshes remplacés par une transformation
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+};
+
+// Chaque mesh est ramené à sa forme canonique (centre de gravité, moments principaux d'inertie),
+// regroupé par topologie, puis comparé aux prototypes du groupe : moments invariants à une tolérance
+// près, puis sommet par sommet après recalage rigide. Les copies doivent garder le même ordre de
+// sommets et d'indices, ce qui est le cas des objets dupliqués dans un modeleur.
+std::vector<MeshInstance> findInstances(const std::vector<MeshView>& meshes, const InstancingOptions& options,
+                                        InstancingStats* stats = nullptr);
@@ -0,0 +1,100 @@
+#include "load_profiler.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+std::string escapeJson(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+// Quantité par seconde, 0 si l'étape est trop courte pour être mesurée
+double perSecond(uint64_t amount, double milliseconds) {
+    return milliseconds > 0.0 ? static_cast<double>(amount) / (milliseconds / 1000.0) : 0.0;
+}
+
+} // namespace
+
+void LoadProfiler::begin(const std::string& name) {
+    if (!enabled_) {
+        return;
+    }
+    current_ = name;
+    start_ = std::chrono::steady_clock::now();
+}
+
+void LoadProfiler::end(uint64_t bytes, uint64_t vertices, uint64_t faces) {
+    if (!enabled_ || current_.empty()) {
+        return;
+    }
+    Phase phase;
+    phase.name = current_;
+    phase.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    phase.bytes = bytes;
+    phase.vertices = vertices;
+    phase.faces = faces;
+    phases_.push_back(phase);
+    current_.clear();
+}
+
+double LoadProfiler::totalMilliseconds() const {
+    double total = 0.0;
+    for (const Phase& phase : phases_) {
+        total += phase.milliseconds;
+    }
+    return total;
+}
+
+void LoadProfiler::printReport(std::ostream& out) const {
+    const double total = totalMilliseconds();
+    std::ostream::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(2);
+    out << "Profil du chargement (" << total << " ms)\n";
+    out << std::left << std::setw(18) << "phase" << std::right << std::setw(10) << "ms" << std::setw(8) << "%"
+        << std::setw(12) << "Mo" << std::setw(12) << "sommets" << std::setw(12) << "faces"
+        << std::setw(10) << "Mo/s" << std::setw(12) << "Msommets/s" << "\n";
+    for (const Phase& phase : phases_) {
+        out << std::left << std::setw(18) << phase.name << std::right << std::setw(10) << phase.milliseconds
+            << std::setw(8) << (total > 0.0 ? 100.0 * phase.milliseconds / total : 0.0)
+            << std::setw(12) << phase.bytes / (1024.0 * 1024.0) << std::setw(12) << phase.vertices
+            << std::setw(12) << phase.faces << std::setw(10) << perSecond(phase.bytes, phase.milliseconds) / (1024.0 * 1024.0)
+            << std::setw(12) << perSecond(phase.vertices, phase.milliseconds) / 1e6 << "\n";
+    }
+    out.flags(flags);
+}
+
+std::string LoadProfiler::toJson(const std::string& modelPath, const std::string& loader) const {
+    std::ostringstream out;
+    out << std::setprecision(6);
+    out << "{\"model\":\"" << escapeJson(modelPath) << "\",\"loader\":\"" << escapeJson(loader)
+        << "\",\"total_ms\":" << totalMilliseconds() << ",\"phases\":[";
+    for (size_t i = 0; i < phases_.size(); ++i) {
+        const Phase& phase = phases_[i];
+        out << (i ? "," : "") << "{\"name\":\"" << escapeJson(phase.name) << "\",\"ms\":" << phase.milliseconds
+            << ",\"bytes\":" << phase.bytes << ",\"vertices\":" << phase.vertices << ",\"faces\":" << phase.faces
+            << ",\"bytes_per_s\":" << perSecond(phase.bytes, phase.milliseconds)
+            << ",\"vertices_per_s\":" << perSecond(phase.vertices, phase.milliseconds)
+            << ",\"faces_per_s\":" << perSecond(phase.faces, phase.milliseconds) << "}";
+    }
+    out << "]}";
+    return out.str();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Chronométrage des étapes du chargement (--profile-load). Chaque étape enregistre sa durée
+// (horloge monotone) et la quantité de données traitée, dont on déduit le débit.
+// Désactivé, begin()/end() ne font rien.
+class LoadProfiler {
+public:
+    struct Phase {
+        std::string name;
+        double milliseconds = 0.0;
+        uint64_t bytes = 0;
+        uint64_t vertices = 0;
+        uint64_t faces = 0;
+    };
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    void begin(const std::string& name);
+    void end(uint64_t bytes = 0, uint64_t vertices = 0, uint64_t faces = 0);
+
+    const std::vector<Phase>& phases() const { return phases_; }
+    double totalMilliseconds() const;
+
+    // Tableau lisible : durée, part du total, quantités et débits par étape
+    void printReport(std::ostream& out) const;
+
+    // Résumé JSON sur une ligne, stable d'une version à l'autre pour comparer les chargements
+    std::string toJson(const std::string& modelPath, const std::string& loader) const;
+
+private:
+    bool enabled_ = false;
+    std::vector<Phase> phases_;
+    std::string current_;
+    std::chrono::steady_clock::time_point start_;
+};
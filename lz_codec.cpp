@@ -0,0 +1,165 @@
+#include "lz_codec.h"
+
+#include <cstring>
+
+namespace {
+
+const size_t kMinMatch = 4;
+const size_t kMaxOffset = 65535;
+const size_t kLastLiterals = 5;   // la fin du bloc est toujours émise en littéraux
+const unsigned int kHashBits = 14;
+const unsigned int kSkipTrigger = 6; // le pas de recherche grandit après 2^6 échecs consécutifs
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+// Séquence : jeton (longueur des littéraux | longueur de copie - 4, 4 bits chacune),
+// octets d'extension des longueurs, littéraux, distance sur 16 bits
+void emitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength, size_t offset,
+                  size_t matchLength) {
+    const size_t matchCode = matchLength - kMinMatch;
+    out.push_back(static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) |
+                                       (matchCode < 15 ? matchCode : 15)));
+    if (literalLength >= 15) {
+        writeLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+    out.push_back(static_cast<uint8_t>(offset & 0xff));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        writeLength(out, matchCode - 15);
+    }
+}
+
+void emitLastLiterals(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength) {
+    out.push_back(static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4));
+    if (literalLength >= 15) {
+        writeLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+}
+
+bool readLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+size_t lzCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+    const size_t start = out.size();
+    out.reserve(start + size + size / 255 + 16);
+
+    size_t anchor = 0;
+    if (size > kMinMatch + kLastLiterals) {
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+        const size_t limit = size - kLastLiterals - kMinMatch;
+        size_t ip = 1;
+        unsigned int misses = 0;
+        while (ip <= limit) {
+            const uint32_t sequence = read32(src + ip);
+            const uint32_t h = hashSequence(sequence);
+            const size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ip - candidate > kMaxOffset || read32(src + candidate) != sequence || candidate >= ip) {
+                ip += 1 + (misses++ >> kSkipTrigger);
+                continue;
+            }
+            misses = 0;
+
+            // Extension de la correspondance vers l'arrière puis vers l'avant
+            size_t matchStart = ip;
+            size_t reference = candidate;
+            while (matchStart > anchor && reference > 0 && src[matchStart - 1] == src[reference - 1]) {
+                --matchStart;
+                --reference;
+            }
+            size_t matchEnd = ip + kMinMatch;
+            const size_t matchLimit = size - kLastLiterals;
+            while (matchEnd < matchLimit && src[matchEnd] == src[reference + (matchEnd - matchStart)]) {
+                ++matchEnd;
+            }
+
+            emitSequence(out, src + anchor, matchStart - anchor, matchStart - reference, matchEnd - matchStart);
+            anchor = matchEnd;
+            ip = matchEnd;
+            if (ip - 2 > 0 && ip - 2 <= limit) {
+                table[hashSequence(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+            }
+        }
+    }
+    emitLastLiterals(out, src + anchor, size - anchor);
+    return out.size() - start;
+}
+
+bool lzDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* const end = src + srcSize;
+    size_t op = 0;
+    while (ip < end) {
+        const uint8_t token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, end, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(end - ip) || literalLength > dstSize - op) {
+            return false;
+        }
+        std::memcpy(dst + op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+        if (ip == end) {
+            break; // dernière séquence : littéraux seuls
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, end, matchLength)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+        if (offset == 0 || offset > op || matchLength > dstSize - op) {
+            return false;
+        }
+
+        uint8_t* out = dst + op;
+        const uint8_t* match = out - offset;
+        if (offset >= matchLength) {
+            std::memcpy(out, match, matchLength);
+        } else {
+            // Copie qui se recouvre (motif répété) : octet par octet
+            for (size_t i = 0; i < matchLength; ++i) {
+                out[i] = match[i];
+            }
+        }
+        op += matchLength;
+    }
+    return op == dstSize;
+}
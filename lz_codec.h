@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compression LZ77 à octets alignés (séquences littéraux + copie, dans l'esprit de LZ4),
+// sans dépendance externe : compression rapide, décompression de plusieurs Go/s par coeur.
+// Les distances de copie sont limitées à 64 Ko ; chaque appel compresse un bloc indépendant.
+
+// Ajoute la forme compressée de src à la fin de out ; retourne le nombre d'octets ajoutés
+size_t lzCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& out);
+
+// Décompresse exactement dstSize octets ; faux si les données sont corrompues ou tronquées
+bool lzDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
@@ -1,3 +1,4 @@
+#include <glad/glad.h> // avant les en-têtes OpenGL de freeglut
 #include <GL/freeglut.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -5,9 +6,40 @@
 #include <iostream>
 #include <vector>
 #include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <chrono> // For time keeping
+#include <fstream>
+#include <thread>
+
+#include "compact_mesh.h"
+#include "file_watcher.h"
+#include "geometry_arena.h"
+#include "glb_loader.h"
+#include "gl_matrix.h"
+#include "gpu_mesh.h"
+#include "headless_context.h"
+#include "instancing.h"
+#include "load_profiler.h"
+#include "memory_usage.h"
+#include "mesh_cache.h"
+#include "mesh_optimize.h"
+#include "mesh_pack.h"
+#include "obj_index.h"
+#include "obj_parser.h"
+#include "obj_stream.h"
+#include "parallel.h"
+#include "ply_loader.h"
+#include "scene_builder.h"
+#include "soft_raster.h"
+#include "stl_loader.h"
+#include "vertex_pipeline.h"
+#include "weld.h"
 
 // Paramètres de la caméra
 float cameraAngleX = 0.0f;
@@ -15,6 +47,11 @@ float cameraAngleY = 0.0f;
 float cameraDistance = 5.0f;
 float cameraPosX = 0.0f;
 float cameraPosY = 0.0f;
+int viewportWidth = 1, viewportHeight = 1; // dernière taille passée à reshape()
+
+// Élimination des meshes dont la boîte englobante sort du champ (désactivée par --no-culling)
+bool useFrustumCulling = true;
+float frameViewProjection[16]; // projection * caméra de l'image en cours, pour renderNode()
 
 // Contrôle de la souris
 bool isDragging = false;
@@ -24,6 +61,121 @@ int lastMouseX, lastMouseY;
 const aiScene* scene = nullptr;
 Assimp::Importer importer;
 std::string modelPath = "drone.obj";
+std::unique_ptr<aiScene> ownedScene; // Scène construite par un chargeur natif
+
+// Rendu sans fenêtre (--headless=image.ppm ou .png) : la scène est dessinée par display() dans un framebuffer
+// hors écran (--size=LxH), depuis la caméra --camera=angleX,angleY[,distance], sur --frames images
+bool headless = false;
+std::string headlessOutput;
+int headlessWidth = 800, headlessHeight = 600;
+int headlessFrames = 1;
+float requestedCameraDistance = 0.0f; // 0 : distance calculée d'après les boîtes englobantes
+HeadlessContext headlessContext;
+bool useSoftwareRenderer = false; // --software : pixellisation sur le processeur, sans contexte OpenGL
+
+// Demande un nouvel affichage à GLUT ; sans fenêtre, chaque image est dessinée explicitement
+void requestRedisplay() {
+    if (!headless) {
+        glutPostRedisplay();
+    }
+}
+
+// Chargeur du modèle
+enum class ModelLoader {
+    Assimp,
+    ParallelObj, // tiny_obj_loader en parallèle (--parallel-obj)
+    MappedObj,   // mmap + analyse sans copie (--mmap-obj)
+    ArenaObj,    // LoadObjWithCallback vers une arène unique (--arena-obj)
+    Glb,         // .glb projeté en mémoire, sans copie (choisi d'après l'extension)
+    Stl,         // STL binaire, copie par blocs puis fusion des sommets (choisi d'après l'extension)
+    Ply          // PLY binaire (choisi d'après l'extension)
+};
+ModelLoader modelLoader = ModelLoader::Assimp;
+
+// Cache binaire des meshes à côté du modèle (--mesh-cache). Lu sans copie : les meshes présents dans
+// cachedMeshes sont dessinés et déposés sur le GPU depuis le fichier projeté, leur aiMesh ne porte que le nom
+bool useMeshCache = false;
+MeshCache sceneCache;
+std::unordered_map<int, size_t> cachedMeshes;
+
+// Écriture du conteneur compressé <modèle>.meshpack après le chargement (--write-pack)
+bool useWritePack = false;
+
+// Fusion des sommets par le module weld au lieu de aiProcess_JoinIdenticalVertices (--weld[=epsilon])
+bool useWeld = false;
+float weldEpsilon = 0.0f;
+
+// Rechargement à chaud des objets modifiés (--watch)
+bool useHotReload = false;
+FileWatcher modelWatcher;
+bool reloadPending = false;
+auto lastModelChange = std::chrono::steady_clock::now();
+const int kReloadDelayMs = 300; // attente après le dernier événement, le temps que l'export se termine
+
+// Profil des étapes du chargement (--profile-load[=fichier.json])
+LoadProfiler loadProfiler;
+std::string profileOutputPath;
+
+// Réordonnancement des indices après chargement (--optimize-indices)
+bool useIndexOptimization = false;
+
+// Meshes identiques à un déplacement près dessinés depuis un prototype (--instance-meshes) ;
+// un mesh présent ici n'a plus de géométrie propre
+bool useInstancing = false;
+std::unordered_map<int, MeshInstance> meshInstances;
+
+// Sommets compacts (--compact-vertices) : les meshes présents ici sont dessinés depuis leur forme
+// quantifiée et leur aiMesh ne garde plus de géométrie
+bool useCompactVertices = false;
+std::unordered_map<int, CompactMesh> compactMeshes;
+
+// Arène de géométrie (--arena-obj) : les meshes présents ici sont dessinés depuis leur plage de coins
+// dans l'arène, leur aiMesh ne porte que le nom
+GeometryArena geometryArena;
+std::unordered_map<int, size_t> arenaMeshes;
+
+// Modèle .glb projeté en mémoire : les meshes présents ici sont dessinés directement depuis les
+// accesseurs de leur primitive, leur aiMesh ne porte que le nom
+GlbModel glbModel;
+std::unordered_map<int, size_t> glbMeshes;
+
+// Géométrie à plat pour les chemins sur le processeur (sélection, rendu logiciel), construite au premier
+// besoin puis gardée : indices des aiMesh, dont les sommets sont lus en place, et sommets décodés des
+// primitives .glb. Vidée quand la scène est remplacée ou que les aiMesh perdent leur géométrie.
+std::unordered_map<int, ObjMesh> cpuMeshes;
+static_assert(sizeof(aiVector3D) == 3 * sizeof(float), "sommets des aiMesh lus comme des flottants xyz");
+
+// Mémoire réduite (--lean-memory) : après le chargement, les meshes présents ici sont dessinés depuis
+// leurs tableaux de sommets et d'indices ; la scène Assimp est libérée et l'aiScene ne porte que les noms
+bool useLeanMemory = false;
+std::unordered_map<int, ObjMesh> leanMeshes;
+
+// Tampons de sommets et d'indices sur le GPU, déposés au chargement (désactivés par --immediate) :
+// les meshes présents ici sont dessinés par glDrawElements, sans renvoyer leurs sommets à chaque image
+bool useGpuBuffers = true;
+std::unordered_map<int, GpuMesh> gpuMeshes;
+
+// Listes d'affichage compilées une fois par mesh (--display-lists), pour les contextes anciens sans
+// tampons de sommets : renderNode() ne fait plus varier que la couleur et la transformation
+bool useDisplayLists = false;
+std::unordered_map<int, GLuint> displayLists;
+
+// Chargement progressif en arrière-plan (--stream)
+bool useStreaming = false;
+bool streamingActive = false;
+ObjStreamLoader streamLoader;
+auto streamStartTime = std::chrono::steady_clock::now();
+
+// Scène répartie sur plusieurs fichiers OBJ passés en arguments : lectures groupées (io_uring)
+// et analyse au fil des lectures, les pièces s'ajoutant à la scène comme en --stream
+std::vector<std::string> modelPaths;
+bool loadingParts = false;
+ObjPartsLoader partsLoader;
+
+// Chargement partiel par objet via l'index des blocs `o` (--objects=nom1,nom2)
+std::vector<std::string> requestedObjects;
+ObjIndex objectIndex;
+std::vector<bool> objectLoaded;
 
 // Sélection
 std::set<int> selectedMeshes;
@@ -44,9 +196,15 @@ float selectedMeshTranslateX = 0.0f;
 float selectedMeshTranslateY = 0.0f;
 float selectedMeshTranslateZ = 0.0f;
 
-// Sources de lumière
+// Sources de lumière (directionnelles, positions données dans le repère de la caméra)
 const int NUM_LIGHTS = 4;
 bool lightEnabled[NUM_LIGHTS] = {true, true, true, true};
+GLfloat lightPositions[NUM_LIGHTS][4] = {
+    {0.0f, -1.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f, 0.0f},
+    {-1.0f, 0.0f, 0.0f, 0.0f},
+    {1.0f, 0.0f, 0.0f, 0.0f}
+};
 GLfloat lightColors[NUM_LIGHTS][4] = {
     {1.0f, 1.0f, 1.0f, 1.0f},
     {1.0f, 1.0f, 1.0f, 1.0f},
@@ -61,22 +219,19 @@ struct AABB {
 };
 std::unordered_map<int, AABB> meshAABBs;
 
-// Fonction pour charger le modèle et calculer la distance initiale
-float calculateInitialDistance(const aiScene* scene) {
+// Fonction pour calculer la distance initiale à partir des boîtes englobantes des meshes
+float calculateInitialDistance(const std::unordered_map<int, AABB>& aabbs) {
     aiVector3D min(FLT_MAX, FLT_MAX, FLT_MAX);
     aiVector3D max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 
-    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-        aiMesh* mesh = scene->mMeshes[i];
-        for (unsigned int j = 0; j < mesh->mNumVertices; ++j) {
-            aiVector3D vertex = mesh->mVertices[j];
-            min.x = std::min(min.x, vertex.x);
-            min.y = std::min(min.y, vertex.y);
-            min.z = std::min(min.z, vertex.z);
-            max.x = std::max(max.x, vertex.x);
-            max.y = std::max(max.y, vertex.y);
-            max.z = std::max(max.z, vertex.z);
-        }
+    for (const auto& pair : aabbs) {
+        const AABB& aabb = pair.second;
+        min.x = std::min(min.x, aabb.min.x);
+        min.y = std::min(min.y, aabb.min.y);
+        min.z = std::min(min.z, aabb.min.z);
+        max.x = std::max(max.x, aabb.max.x);
+        max.y = std::max(max.y, aabb.max.y);
+        max.z = std::max(max.z, aabb.max.z);
     }
 
     aiVector3D size = max - min;
@@ -101,34 +256,1222 @@ AABB calculateMeshAABB(const aiMesh* mesh) {
     return aabb;
 }
 
-void loadModel(const std::string& path) {
-    scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        std::cerr << "Erreur de chargement du modèle : " << importer.GetErrorString() << std::endl;
+// Charge le modèle via un chargeur natif (OBJ, STL ou PLY) et construit une scène équivalente.
+// Un STL ou PLY que le chargeur natif refuse (ASCII, variante inconnue) est laissé à Assimp : retourne nullptr.
+const aiScene* loadNativeModel(const std::string& path) {
+    ObjModel model;
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    bool loaded;
+    switch (modelLoader) {
+        case ModelLoader::MappedObj: loaded = loadObjMapped(path, model, &error); break;
+        case ModelLoader::Stl: loaded = loadStlBinary(path, model, &error); break;
+        case ModelLoader::Ply: loaded = loadPlyBinary(path, model, &error); break;
+        default: loaded = loadObjParallel(path, model, &error); break;
+    }
+    if (!loaded && (modelLoader == ModelLoader::Stl || modelLoader == ModelLoader::Ply)) {
+        std::cout << "Chargeur natif ignoré : " << error << std::endl;
+        modelLoader = ModelLoader::Assimp;
+        return nullptr;
+    }
+    if (!loaded) {
+        std::cerr << "Erreur de chargement du modèle : " << error << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (modelLoader == ModelLoader::Stl || modelLoader == ModelLoader::Ply) {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        statSource(path, size, mtime, nullptr);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Lecture " << (modelLoader == ModelLoader::Stl ? "STL" : "PLY") << " : " << size / 1024 << " Ko en " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0.0 ? size / seconds / 1e9 : 0.0) << " Go/s)" << std::endl;
+    }
+    ownedScene.reset(createScene(model));
+    return ownedScene.get();
+}
+
+// Options du chargement en cours, enregistrées avec le cache pour qu'il ne serve qu'au même traitement
+MeshCacheOptions meshCacheOptions() {
+    MeshCacheOptions options;
+    switch (modelLoader) {
+        case ModelLoader::ParallelObj: options.loader = MeshCacheLoader::ParallelObj; break;
+        case ModelLoader::MappedObj: options.loader = MeshCacheLoader::MappedObj; break;
+        case ModelLoader::Stl: options.loader = MeshCacheLoader::Stl; break;
+        case ModelLoader::Ply: options.loader = MeshCacheLoader::Ply; break;
+        default: options.loader = MeshCacheLoader::Assimp; break;
+    }
+    options.weld = useWeld;
+    options.weldEpsilon = weldEpsilon;
+    options.optimizeIndices = useIndexOptimization;
+    return options;
+}
+
+// Charge la scène depuis le cache binaire s'il correspond toujours au modèle. Les meshes restent dans
+// le fichier projeté ; ils ne sont recopiés dans les aiMesh que pour les traitements qui remplacent la
+// géométrie de la scène (instances, sommets compacts, conteneur, rechargement à chaud)
+bool loadCachedScene(const std::string& path) {
+    std::string error;
+    if (!sceneCache.open(meshCachePath(path), path, meshCacheOptions(), &error)) {
+        std::cout << "Cache de meshes ignoré : " << error << std::endl;
+        sceneCache = MeshCache();
+        return false;
+    }
+    const bool copyGeometry = useInstancing || useCompactVertices || useWritePack || useHotReload;
+    std::vector<MeshView> views = sceneCache.meshes();
+    for (size_t i = 0; i < views.size(); ++i) {
+        const MeshBounds& bounds = sceneCache.bounds(i);
+        meshAABBs[i].min = aiVector3D(bounds.min[0], bounds.min[1], bounds.min[2]);
+        meshAABBs[i].max = aiVector3D(bounds.max[0], bounds.max[1], bounds.max[2]);
+        if (!copyGeometry) {
+            cachedMeshes[static_cast<int>(i)] = i;
+            views[i] = MeshView();
+            views[i].name = sceneCache.mesh(i).name;
+        }
+    }
+    ownedScene.reset(createScene(views));
+    scene = ownedScene.get();
+    if (copyGeometry) {
+        sceneCache = MeshCache();
+    }
+    std::cout << "Meshes chargés depuis le cache : " << meshCachePath(path) << (copyGeometry ? "" : " (sans copie)") << std::endl;
+    return true;
+}
+
+// Charge la scène depuis un conteneur .meshpack, décompressé sur tous les coeurs
+void loadPackedScene(const std::string& path) {
+    ObjModel model;
+    std::vector<MeshBounds> bounds;
+    std::string error;
+    if (!readMeshPack(path, model, bounds, &error)) {
+        std::cerr << "Erreur de chargement du modèle : " << error << std::endl;
         exit(EXIT_FAILURE);
     }
+    ownedScene.reset(createScene(model));
+    scene = ownedScene.get();
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        meshAABBs[i].min = aiVector3D(bounds[i].min[0], bounds[i].min[1], bounds[i].min[2]);
+        meshAABBs[i].max = aiVector3D(bounds[i].max[0], bounds[i].max[1], bounds[i].max[2]);
+    }
+}
+
+// Charge le modèle dans l'arène de géométrie ; la scène ne contient que les noms des meshes
+void loadArenaScene(const std::string& path) {
+    std::string error;
+    if (!geometryArena.load(path, &error)) {
+        std::cerr << "Erreur de chargement du modèle : " << error << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const std::vector<ArenaMesh>& meshes = geometryArena.meshes();
+    std::vector<MeshView> views(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        views[i].name = meshes[i].name;
+        arenaMeshes[static_cast<int>(i)] = i;
+        const MeshBounds& bounds = meshes[i].bounds;
+        meshAABBs[i].min = aiVector3D(bounds.min[0], bounds.min[1], bounds.min[2]);
+        meshAABBs[i].max = aiVector3D(bounds.max[0], bounds.max[1], bounds.max[2]);
+    }
+    ownedScene.reset(createScene(views));
+    scene = ownedScene.get();
+    std::cout << "Arène de géométrie : " << geometryArena.byteSize() / 1024 << " Ko en une allocation, "
+              << geometryArena.vertexCount() << " sommets, " << geometryArena.indexCount() / 3 << " triangles" << std::endl;
+}
+
+// Projette un .glb et référence ses primitives sans copie ; la scène ne contient que les noms des meshes
+void loadGlbScene(const std::string& path) {
+    std::string error;
+    if (!glbModel.open(path, &error)) {
+        std::cerr << "Erreur de chargement du modèle : " << error << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const std::vector<GlbPrimitive>& primitives = glbModel.primitives();
+    std::vector<MeshView> views(primitives.size());
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        views[i].name = primitives[i].name;
+        glbMeshes[static_cast<int>(i)] = i;
+        const MeshBounds& bounds = primitives[i].bounds;
+        meshAABBs[i].min = aiVector3D(bounds.min[0], bounds.min[1], bounds.min[2]);
+        meshAABBs[i].max = aiVector3D(bounds.max[0], bounds.max[1], bounds.max[2]);
+    }
+    ownedScene.reset(createScene(views));
+    scene = ownedScene.get();
+}
+
+// Écrit les meshes de la scène dans le conteneur compressé <modèle>.meshpack
+void saveScenePack(const std::string& path) {
+    ObjModel model = extractModel(scene);
+    std::vector<MeshBounds> bounds(model.meshes.size());
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        const AABB& aabb = meshAABBs[i];
+        bounds[i] = {{aabb.min.x, aabb.min.y, aabb.min.z}, {aabb.max.x, aabb.max.y, aabb.max.z}};
+    }
+    std::string error;
+    MeshPackStats stats;
+    if (!writeMeshPack(meshPackPath(path), model.views(), bounds, &error, &stats)) {
+        std::cerr << "Impossible d'écrire le conteneur compressé : " << error << std::endl;
+        return;
+    }
+    std::cout << "Conteneur compressé écrit : " << meshPackPath(path) << " (" << stats.rawBytes / 1024 << " -> "
+              << stats.packedBytes / 1024 << " Ko, " << stats.blockCount << " blocs)" << std::endl;
+}
+
+// Écrit le cache binaire des meshes de la scène et de leurs boîtes englobantes
+void saveSceneCache(const std::string& path) {
+    ObjModel model = extractModel(scene);
+    std::vector<MeshBounds> bounds(model.meshes.size());
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        const AABB& aabb = meshAABBs[i];
+        bounds[i] = {{aabb.min.x, aabb.min.y, aabb.min.z}, {aabb.max.x, aabb.max.y, aabb.max.z}};
+    }
+    std::string error;
+    if (!writeMeshCache(meshCachePath(path), path, model, bounds, meshCacheOptions(), &error)) {
+        std::cerr << "Impossible d'écrire le cache de meshes : " << error << std::endl;
+    }
+}
+
+// Initialise l'état d'affichage d'un mesh de la scène
+void initMeshState(unsigned int i) {
+    aiMesh* mesh = scene->mMeshes[i];
+    std::string meshName = mesh->mName.C_Str();
+    std::cout << "Mesh " << i << " : " << meshName << std::endl;
+
+    meshVisibility[i] = true;
+
+    GLfloat defaultColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    std::copy(defaultColor, defaultColor + 4, meshColors[i]);
+
+    meshPositions[i] = aiVector3D(0.0f, 0.0f, 0.0f);
+    meshRotations[i] = 0.0f; // Initialize rotation
+}
+
+// Remplace la scène par une copie dont les sommets identiques sont fusionnés
+void weldScene() {
+    auto start = std::chrono::steady_clock::now();
+    ObjModel model = extractModel(scene);
+    WeldOptions options;
+    options.epsilon = weldEpsilon;
+    WeldStats stats;
+    weldModel(model, options, &stats);
+    ownedScene.reset(createScene(model));
+    scene = ownedScene.get();
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "Fusion des sommets (epsilon " << weldEpsilon << ") : " << stats.verticesBefore << " -> "
+              << stats.verticesAfter << " sommets, " << stats.bytesBefore / 1024 << " -> " << stats.bytesAfter / 1024
+              << " Ko, en " << elapsed.count() << " ms" << std::endl;
+}
+
+// Réordonne triangles et sommets de chaque mesh (cache de sommets, surdessin, localité des lectures)
+void optimizeSceneIndices() {
+    auto start = std::chrono::steady_clock::now();
+    ObjModel model = extractModel(scene);
+    std::vector<MeshOptimizeStats> stats(model.meshes.size());
+    parallelFor(model.meshes.size(), [&](size_t i) {
+        optimizeMesh(model.meshes[i], &stats[i]);
+    });
+    ownedScene.reset(createScene(model));
+    scene = ownedScene.get();
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        std::cout << "Indices optimisés " << model.meshes[i].name << " : ACMR " << stats[i].before.acmr << " -> "
+                  << stats[i].after.acmr << ", ATVR " << stats[i].before.atvr << " -> " << stats[i].after.atvr << std::endl;
+    }
+    std::cout << "Optimisation des indices en " << elapsed.count() << " ms" << std::endl;
+}
+
+// Récupère la scène de l'importeur Assimp pour pouvoir la modifier
+void takeSceneOwnership() {
+    if (scene != ownedScene.get()) {
+        ownedScene.reset(importer.GetOrphanedScene());
+        scene = ownedScene.get();
+    }
+}
+
+// Remplace les meshes qui sont des copies déplacées d'un autre par une transformation de celui-ci
+void instanceDuplicateMeshes() {
+    if (!useInstancing) {
+        return;
+    }
+    takeSceneOwnership();
+    ObjModel model = extractModel(scene);
+    InstancingStats stats;
+    std::vector<MeshInstance> instances = findInstances(model.views(), InstancingOptions(), &stats);
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        if (instances[i].prototype != i) {
+            meshInstances[i] = instances[i];
+            releaseGeometry(ownedScene->mMeshes[i]);
+            cpuMeshes.erase(i);
+        }
+    }
+    if (stats.instances > 0) {
+        std::cout << "Instances : " << stats.prototypes << " géométries uniques, " << stats.instances
+                  << " meshes devenus des instances, sommets " << stats.verticesBefore << " -> " << stats.verticesAfter
+                  << std::endl;
+    }
+}
+
+// Quantifie les meshes de la scène qui ne le sont pas encore, d'après leur boîte englobante,
+// puis libère leurs sommets et faces en flottants
+void compactNewMeshes() {
+    if (!useCompactVertices) {
+        return;
+    }
+    takeSceneOwnership();
+
+    size_t bytesBefore = 0, bytesAfter = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        aiMesh* mesh = ownedScene->mMeshes[i];
+        if (compactMeshes.count(i) || mesh->mNumVertices == 0) {
+            continue;
+        }
+        size_t attributes = 1 + (mesh->HasNormals() ? 1 : 0) + (mesh->HasTextureCoords(0) ? 1 : 0);
+        bytesBefore += size_t(mesh->mNumVertices) * attributes * sizeof(aiVector3D) +
+                       size_t(mesh->mNumFaces) * (sizeof(aiFace) + 3 * sizeof(unsigned int));
+
+        const AABB& aabb = meshAABBs[i];
+        MeshBounds bounds = {{aabb.min.x, aabb.min.y, aabb.min.z}, {aabb.max.x, aabb.max.y, aabb.max.z}};
+        ObjMesh source = extractMesh(mesh);
+        compactMeshes[i] = compactMesh(source.view(), bounds);
+        releaseGeometry(mesh);
+        cpuMeshes.erase(i);
+        bytesAfter += compactMeshes[i].byteSize();
+    }
+    if (bytesBefore > 0) {
+        std::cout << "Sommets compacts : " << bytesBefore / 1024 << " -> " << bytesAfter / 1024 << " Ko" << std::endl;
+    }
+}
+
+// Copie la géométrie encore portée par les aiMesh dans leanMeshes, remplace la scène par une scène
+// de noms et libère celle de l'importeur ; boîtes englobantes, état et sélection restent par indice
+void releaseSceneGeometry() {
+    const uint64_t residentBefore = residentBytes();
+    std::vector<MeshView> views(scene->mNumMeshes);
+    size_t leanBytes = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh* mesh = scene->mMeshes[i];
+        views[i].name = mesh->mName.C_Str();
+        if (mesh->mNumVertices == 0 || compactMeshes.count(i) || meshInstances.count(i)) {
+            continue;
+        }
+        ObjMesh& lean = leanMeshes[i] = extractMesh(mesh);
+        leanBytes += (lean.positions.size() + lean.normals.size() + lean.texcoords.size()) * sizeof(float) +
+                     lean.indices.size() * sizeof(unsigned int);
+    }
+    ownedScene.reset(createScene(views));
+    scene = ownedScene.get();
+    cpuMeshes.clear();
+    importer.FreeScene();
+    releaseFreeMemory();
+
+    std::cout << "Scène Assimp libérée : mémoire résidente " << residentBefore / 1024 << " -> " << residentBytes() / 1024
+              << " Ko (géométrie conservée : " << leanBytes / 1024 << " Ko)" << std::endl;
+}
+
+// Dépose sur le GPU les meshes de la scène qui n'y sont pas encore ; les instances dessinent les tampons
+// de leur prototype. La copie du mode mémoire réduite est libérée, les meshes du cache et du .glb sont lus
+// directement dans le fichier projeté, ceux de l'arène dans ses tableaux, et les meshes compacts restent
+// en entiers 16 bits sur le GPU
+void uploadNewMeshes() {
+    if (!useGpuBuffers) {
+        return;
+    }
+    size_t bytes = 0, uploaded = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        auto gpu = gpuMeshes.find(i);
+        if (gpu != gpuMeshes.end() && meshInstances.count(i)) {
+            releaseGpuMesh(gpu->second); // devenu une instance lors d'un rechargement
+            gpuMeshes.erase(gpu);
+            continue;
+        }
+        if (gpu != gpuMeshes.end() || meshInstances.count(i)) {
+            continue;
+        }
+        GpuMesh uploadedMesh;
+        auto compact = compactMeshes.find(i);
+        auto glb = glbMeshes.find(i);
+        auto lean = leanMeshes.find(i);
+        auto cached = cachedMeshes.find(i);
+        auto arena = arenaMeshes.find(i);
+        if (compact != compactMeshes.end()) {
+            uploadedMesh = uploadCompactMesh(compact->second);
+        } else if (glb != glbMeshes.end()) {
+            uploadedMesh = uploadGlbPrimitive(glbModel.primitives()[glb->second]);
+        } else if (arena != arenaMeshes.end()) {
+            uploadedMesh = uploadMesh(geometryArena.view(arena->second));
+        } else if (cached != cachedMeshes.end()) {
+            uploadedMesh = uploadMesh(sceneCache.mesh(cached->second));
+        } else if (lean != leanMeshes.end()) {
+            uploadedMesh = uploadMesh(lean->second.view());
+            leanMeshes.erase(lean);
+        } else if (scene->mMeshes[i]->mNumVertices > 0) {
+            ObjMesh mesh = extractMesh(scene->mMeshes[i]);
+            uploadedMesh = uploadMesh(mesh.view());
+        } else {
+            continue;
+        }
+        bytes += uploadedMesh.byteSize;
+        ++uploaded;
+        gpuMeshes[i] = uploadedMesh;
+    }
+    if (uploaded > 0) {
+        std::cout << "Tampons GPU : " << uploaded << " meshes, " << bytes / 1024 << " Ko" << std::endl;
+    }
+}
+
+void drawMeshGeometry(int meshIndex, bool withAttributes);
+
+// Compile une liste d'affichage pour chaque mesh qui n'en a pas encore, quelle que soit sa forme
+// (aiMesh, compacte, arène, .glb) ; une instance rejoue la liste de son prototype
+void compileNewDisplayLists() {
+    if (!useDisplayLists) {
+        return;
+    }
+    size_t compiled = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        auto list = displayLists.find(i);
+        if (list != displayLists.end() && meshInstances.count(i)) {
+            glDeleteLists(list->second, 1); // devenu une instance lors d'un rechargement
+            displayLists.erase(list);
+            continue;
+        }
+        if (list != displayLists.end() || meshInstances.count(i)) {
+            continue;
+        }
+        GLuint id = glGenLists(1);
+        glNewList(id, GL_COMPILE);
+        drawMeshGeometry(i, true);
+        glEndList();
+        displayLists[i] = id;
+        ++compiled;
+    }
+    if (compiled > 0) {
+        std::cout << "Listes d'affichage compilées : " << compiled << std::endl;
+    }
+}
+
+// Nombre total de sommets et de faces de la scène, pour le profil du chargement
+uint64_t sceneVertexCount() {
+    uint64_t count = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        count += scene->mMeshes[i]->mNumVertices;
+    }
+    return count;
+}
+
+uint64_t sceneFaceCount() {
+    uint64_t count = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        count += scene->mMeshes[i]->mNumFaces;
+    }
+    return count;
+}
+
+const char* loaderName() {
+    switch (modelLoader) {
+        case ModelLoader::ParallelObj: return "parallel-obj";
+        case ModelLoader::MappedObj: return "mmap-obj";
+        case ModelLoader::ArenaObj: return "arena-obj";
+        case ModelLoader::Glb: return "glb";
+        case ModelLoader::Stl: return "stl";
+        case ModelLoader::Ply: return "ply";
+        default: return "assimp";
+    }
+}
+
+// Affiche le profil et écrit le résumé JSON (dans profileOutputPath, ou sur la sortie standard)
+void reportLoadProfile(const std::string& path, const char* loader) {
+    loadProfiler.printReport(std::cout);
+    std::string json = loadProfiler.toJson(path, loader);
+    if (profileOutputPath.empty()) {
+        std::cout << json << std::endl;
+        return;
+    }
+    std::ofstream out(profileOutputPath);
+    if (!(out << json << "\n")) {
+        std::cerr << "Impossible d'écrire le profil : " << profileOutputPath << std::endl;
+    }
+}
+
+void loadModel(const std::string& path) {
+    uint64_t fileSize = 0;
+    int64_t fileMtime = 0;
+    if (loadProfiler.isEnabled()) {
+        statSource(path, fileSize, fileMtime, nullptr);
+    }
+
+    // Un conteneur .meshpack remplace l'analyse ; ses boîtes englobantes sont déjà calculées
+    // L'arène de géométrie aussi, sans passer par les meshes de l'aiScene
+    const bool fromPack = isMeshPackPath(path);
+    const bool fromArena = !fromPack && modelLoader == ModelLoader::ArenaObj;
+    const bool fromGlb = modelLoader == ModelLoader::Glb;
+    bool fromCache = false;
+    if (fromPack) {
+        loadProfiler.begin("pack_read");
+        loadPackedScene(path);
+        loadProfiler.end(fileSize, sceneVertexCount(), sceneFaceCount());
+    } else if (fromGlb) {
+        loadProfiler.begin("glb_map");
+        loadGlbScene(path);
+        loadProfiler.end(fileSize, 0, 0);
+    } else if (fromArena) {
+        loadProfiler.begin("parse");
+        loadArenaScene(path);
+        loadProfiler.end(fileSize, geometryArena.vertexCount(), geometryArena.indexCount() / 3);
+    } else if (useMeshCache) {
+        loadProfiler.begin("cache_read");
+        fromCache = loadCachedScene(path);
+        uint64_t cacheSize = 0;
+        if (fromCache && loadProfiler.isEnabled()) {
+            statSource(meshCachePath(path), cacheSize, fileMtime, nullptr);
+        }
+        uint64_t cachedVertices = 0, cachedFaces = 0;
+        for (const MeshView& mesh : sceneCache.meshes()) {
+            cachedVertices += mesh.vertexCount;
+            cachedFaces += mesh.indexCount / 3;
+        }
+        loadProfiler.end(cacheSize, fromCache ? cachedVertices + sceneVertexCount() : 0,
+                         fromCache ? cachedFaces + sceneFaceCount() : 0);
+    }
+    if (!fromCache && !fromPack && !fromArena && !fromGlb) {
+        const aiScene* nativeScene = nullptr;
+        if (modelLoader != ModelLoader::Assimp) {
+            loadProfiler.begin("parse");
+            nativeScene = loadNativeModel(path);
+            if (nativeScene) {
+                scene = nativeScene;
+            }
+            loadProfiler.end(fileSize, nativeScene ? sceneVertexCount() : 0, nativeScene ? sceneFaceCount() : 0);
+        }
+        const unsigned int postProcessing =
+            aiProcess_Triangulate | aiProcess_FlipUVs | (useWeld ? 0 : aiProcess_JoinIdenticalVertices);
+        if (!nativeScene && !loadProfiler.isEnabled()) {
+            scene = importer.ReadFile(path, postProcessing);
+            if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+                std::cerr << "Erreur de chargement du modèle : " << importer.GetErrorString() << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (!nativeScene) {
+            // Avec --profile-load, lecture puis post-traitements appliqués séparément pour les chronométrer
+            loadProfiler.begin("parse");
+            scene = importer.ReadFile(path, 0);
+            if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+                std::cerr << "Erreur de chargement du modèle : " << importer.GetErrorString() << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            loadProfiler.end(fileSize, sceneVertexCount(), sceneFaceCount());
+
+            loadProfiler.begin("triangulate");
+            scene = importer.ApplyPostProcessing(aiProcess_Triangulate);
+            if (scene) {
+                loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+                loadProfiler.begin(useWeld ? "flip_uvs" : "join_vertices");
+                scene = importer.ApplyPostProcessing(postProcessing & ~aiProcess_Triangulate);
+            }
+            if (!scene) {
+                std::cerr << "Erreur de chargement du modèle : " << importer.GetErrorString() << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+        }
+        if (useWeld) {
+            loadProfiler.begin("weld");
+            weldScene();
+            loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+        }
+        if (useIndexOptimization) {
+            loadProfiler.begin("optimize_indices");
+            optimizeSceneIndices();
+            loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+        }
+    }
     std::cout << "Modèle chargé avec succès : " << path << std::endl;
 
     std::cout << "Nombre de meshes dans le modèle : " << scene->mNumMeshes << std::endl;
 
+    loadProfiler.begin("mesh_state");
     for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-        aiMesh* mesh = scene->mMeshes[i];
-        std::string meshName = mesh->mName.C_Str();
-        std::cout << "Mesh " << i << " : " << meshName << std::endl;
+        initMeshState(i);
+    }
+    loadProfiler.end();
+    if (!fromCache && !fromPack && !fromArena && !fromGlb) {
+        loadProfiler.begin("aabb");
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            aiMesh* mesh = scene->mMeshes[i];
+            meshAABBs[i] = calculateMeshAABB(mesh);
+        }
+        loadProfiler.end(0, sceneVertexCount(), 0);
+        if (useMeshCache) {
+            loadProfiler.begin("cache_write");
+            saveSceneCache(path);
+            loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+        }
+    }
+    if (useWritePack && !fromPack) {
+        loadProfiler.begin("pack_write");
+        saveScenePack(path);
+        loadProfiler.end(0, sceneVertexCount(), sceneFaceCount());
+    }
+    if (useInstancing) {
+        const uint64_t vertices = sceneVertexCount(), faces = sceneFaceCount();
+        loadProfiler.begin("instancing");
+        instanceDuplicateMeshes();
+        loadProfiler.end(0, vertices, faces);
+    }
+    if (useCompactVertices) {
+        const uint64_t vertices = sceneVertexCount(), faces = sceneFaceCount();
+        loadProfiler.begin("compact");
+        compactNewMeshes();
+        loadProfiler.end(0, vertices, faces);
+    }
+    if (useLeanMemory) {
+        const uint64_t vertices = sceneVertexCount(), faces = sceneFaceCount();
+        loadProfiler.begin("release_scene");
+        releaseSceneGeometry();
+        loadProfiler.end(0, vertices, faces);
+    }
+    if (useGpuBuffers) {
+        const uint64_t vertices = sceneVertexCount(), faces = sceneFaceCount();
+        loadProfiler.begin("gpu_upload");
+        uploadNewMeshes();
+        loadProfiler.end(0, vertices, faces);
+    }
+    if (useDisplayLists) {
+        const uint64_t vertices = sceneVertexCount(), faces = sceneFaceCount();
+        loadProfiler.begin("display_lists");
+        compileNewDisplayLists();
+        loadProfiler.end(0, vertices, faces);
+    }
+    loadProfiler.begin("initial_distance");
+    cameraDistance = calculateInitialDistance(meshAABBs);
+    loadProfiler.end();
+
+    if (loadProfiler.isEnabled()) {
+        reportLoadProfile(path, fromPack ? "mesh-pack" : fromCache ? "mesh-cache" : loaderName());
+    }
+}
+
+// Ajoute à la scène les objets d'indices `selected` dans l'index et initialise leur état
+void appendIndexedObjects(const std::string& path, const std::vector<size_t>& selected) {
+    ObjModel model;
+    std::string error;
+    if (!loadObjObjects(path, objectIndex, selected, model, &error)) {
+        std::cerr << "Erreur de chargement des objets : " << error << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i : selected) {
+        objectLoaded[i] = true;
+    }
+
+    unsigned int first = scene->mNumMeshes;
+    appendMeshes(ownedScene.get(), model.views());
+    for (unsigned int i = first; i < scene->mNumMeshes; ++i) {
+        initMeshState(i);
+        meshAABBs[i] = calculateMeshAABB(scene->mMeshes[i]);
+    }
+    compactNewMeshes();
+    uploadNewMeshes();
+    compileNewDisplayLists();
+    if (!meshAABBs.empty()) {
+        cameraDistance = calculateInitialDistance(meshAABBs);
+    }
+}
+
+// Construit (ou relit) l'index des objets puis ne charge que les objets demandés
+void loadIndexedModel(const std::string& path) {
+    std::string error;
+    if (!loadOrBuildObjIndex(path, objectIndex, &error)) {
+        std::cerr << "Erreur d'indexation du modèle : " << error << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    objectLoaded.assign(objectIndex.objects.size(), false);
+
+    std::vector<size_t> selected = findObjects(objectIndex, requestedObjects);
+    if (selected.empty()) {
+        std::cerr << "Aucun objet du modèle ne correspond à --objects" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ownedScene.reset(createScene(std::vector<MeshView>()));
+    scene = ownedScene.get();
+    appendIndexedObjects(path, selected);
+    std::cout << "Objets chargés : " << selected.size() << " sur " << objectIndex.objects.size()
+              << " (touche l pour charger le reste)" << std::endl;
+}
+
+// Charge les objets de l'index qui ne l'ont pas encore été
+void loadRemainingObjects() {
+    std::vector<size_t> remaining;
+    for (size_t i = 0; i < objectLoaded.size(); ++i) {
+        if (!objectLoaded[i]) {
+            remaining.push_back(i);
+        }
+    }
+    if (remaining.empty()) {
+        return;
+    }
+    appendIndexedObjects(modelPath, remaining);
+    std::cout << "Objets restants chargés : " << remaining.size() << std::endl;
+}
+
+// Indexe le modèle chargé et commence à surveiller le fichier
+void startWatchingModel(const std::string& path) {
+    if (isMeshPackPath(path)) {
+        std::cerr << "Rechargement à chaud désactivé : " << path << " n'est pas un fichier OBJ" << std::endl;
+        return;
+    }
+    std::string error;
+    if (objectIndex.objects.empty()) {
+        if (!loadOrBuildObjIndex(path, objectIndex, &error)) {
+            std::cerr << "Rechargement à chaud désactivé : " << error << std::endl;
+            return;
+        }
+        objectLoaded.assign(objectIndex.objects.size(), true);
+    }
+    if (!modelWatcher.watch(path, &error)) {
+        std::cerr << "Rechargement à chaud désactivé : " << error << std::endl;
+        return;
+    }
+    std::cout << "Surveillance de " << path << std::endl;
+}
+
+// Relit l'index du fichier modifié, ne réanalyse que les objets `o` dont le bloc a changé et
+// remplace leurs meshes dans la scène. Position, couleur, visibilité, rotation et sélection
+// suivent les meshes par leur nom. Les objets connus mais non chargés (--objects) le restent.
+void reloadChangedObjects() {
+    auto start = std::chrono::steady_clock::now();
+    ObjIndex newIndex;
+    std::string error;
+    if (!loadOrBuildObjIndex(modelPath, newIndex, &error)) {
+        std::cerr << "Rechargement impossible : " << error << std::endl;
+        return;
+    }
+    const std::vector<bool> unchanged = findUnchangedObjects(objectIndex, newIndex);
+
+    std::unordered_set<std::string> knownNames;
+    for (const ObjObjectEntry& entry : objectIndex.objects) {
+        knownNames.insert(entry.name);
+    }
+    std::unordered_map<std::string, std::vector<unsigned int>> oldMeshesByName;
+    std::unordered_set<std::string> instancedNames; // sans géométrie propre : toujours réanalysés
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        oldMeshesByName[scene->mMeshes[i]->mName.C_Str()].push_back(i);
+        if (meshInstances.count(i)) {
+            instancedNames.insert(scene->mMeshes[i]->mName.C_Str());
+        }
+    }
+
+    // Objets conservés tels quels et objets à réanalyser, dans l'ordre du fichier
+    std::vector<size_t> toParse;
+    std::vector<size_t> present;
+    std::vector<bool> kept(newIndex.objects.size(), false);
+    std::unordered_set<std::string> keptNames;
+    for (size_t i = 0; i < newIndex.objects.size(); ++i) {
+        const std::string& name = newIndex.objects[i].name;
+        const bool inScene = oldMeshesByName.count(name) > 0;
+        if (!inScene && knownNames.count(name)) {
+            continue;
+        }
+        present.push_back(i);
+        if (unchanged[i] && inScene && !instancedNames.count(name) && keptNames.insert(name).second) {
+            kept[i] = true;
+            continue;
+        }
+        toParse.push_back(i);
+    }
+
+    ObjModel parsed;
+    if (!loadObjObjects(modelPath, newIndex, toParse, parsed, &error)) {
+        // Fichier peut-être encore en cours d'écriture : la scène actuelle est gardée
+        std::cerr << "Rechargement impossible : " << error << std::endl;
+        return;
+    }
+    std::unordered_map<std::string, std::vector<ObjMesh*>> parsedByName;
+    for (ObjMesh& mesh : parsed.meshes) {
+        if (useWeld) {
+            WeldOptions options;
+            options.epsilon = weldEpsilon;
+            weldMesh(mesh, options);
+        }
+        if (useIndexOptimization) {
+            optimizeMesh(mesh);
+        }
+        parsedByName[mesh.name].push_back(&mesh);
+    }
+
+    // Nouvelle liste de meshes ; source[j] est l'ancien mesh dont le nouveau reprend l'état (-1 : aucun)
+    takeSceneOwnership();
+    std::vector<aiMesh*> meshes;
+    std::vector<int> source;
+    std::vector<bool> reused;
+    for (size_t i : present) {
+        const std::string& name = newIndex.objects[i].name;
+        auto old = oldMeshesByName.find(name);
+        if (kept[i]) {
+            for (unsigned int o : old->second) {
+                meshes.push_back(ownedScene->mMeshes[o]);
+                ownedScene->mMeshes[o] = nullptr; // repris par la nouvelle scène
+                source.push_back(static_cast<int>(o));
+                reused.push_back(true);
+            }
+            continue;
+        }
+        auto fresh = parsedByName.find(name);
+        if (fresh == parsedByName.end()) {
+            continue; // bloc sans face
+        }
+        for (size_t k = 0; k < fresh->second.size(); ++k) {
+            meshes.push_back(createMesh(fresh->second[k]->view()));
+            const bool hasOld = old != oldMeshesByName.end() && k < old->second.size();
+            source.push_back(hasOld ? static_cast<int>(old->second[k]) : -1);
+            reused.push_back(false);
+        }
+        parsedByName.erase(fresh);
+    }
+
+    std::unordered_map<int, bool> visibility;
+    std::unordered_map<int, GLfloat[4]> colors;
+    std::unordered_map<int, aiVector3D> positions;
+    std::unordered_map<int, float> rotations;
+    std::unordered_map<int, AABB> aabbs;
+    std::unordered_map<int, CompactMesh> compact;
+    std::unordered_map<int, GpuMesh> gpu;
+    std::unordered_map<int, GLuint> lists;
+    std::set<int> selection;
+    for (int j = 0; j < static_cast<int>(meshes.size()); ++j) {
+        const int o = source[j];
+        if (o >= 0) {
+            visibility[j] = meshVisibility[o];
+            std::copy(meshColors[o], meshColors[o] + 4, colors[j]);
+            positions[j] = meshPositions[o];
+            rotations[j] = meshRotations[o];
+            if (selectedMeshes.count(o)) {
+                selection.insert(j);
+            }
+        }
+        if (reused[j]) {
+            aabbs[j] = meshAABBs[o];
+            auto packed = compactMeshes.find(o);
+            if (packed != compactMeshes.end()) {
+                compact[j] = std::move(packed->second);
+            }
+            auto uploaded = gpuMeshes.find(o);
+            if (uploaded != gpuMeshes.end()) {
+                gpu[j] = uploaded->second;
+                gpuMeshes.erase(uploaded);
+            }
+            auto list = displayLists.find(o);
+            if (list != displayLists.end()) {
+                lists[j] = list->second;
+                displayLists.erase(list);
+            }
+        } else {
+            aabbs[j] = calculateMeshAABB(meshes[j]);
+        }
+    }
+
+    const size_t keptMeshes = std::count(reused.begin(), reused.end(), true);
+    const size_t droppedMeshes = scene->mNumMeshes - keptMeshes;
+    ownedScene.reset(createScene(meshes));
+    scene = ownedScene.get();
+    cpuMeshes.clear();
+    meshVisibility.swap(visibility);
+    meshColors.swap(colors);
+    meshPositions.swap(positions);
+    meshRotations.swap(rotations);
+    meshAABBs.swap(aabbs);
+    compactMeshes.swap(compact);
+    for (auto& replaced : gpuMeshes) {
+        releaseGpuMesh(replaced.second);
+    }
+    gpuMeshes.swap(gpu);
+    for (const auto& replaced : displayLists) {
+        glDeleteLists(replaced.second, 1);
+    }
+    displayLists.swap(lists);
+    selectedMeshes.swap(selection);
+    for (unsigned int j = 0; j < scene->mNumMeshes; ++j) {
+        if (source[j] < 0) {
+            initMeshState(j);
+        }
+    }
+    meshInstances.clear();
+    instanceDuplicateMeshes();
+    compactNewMeshes();
+    uploadNewMeshes();
+    compileNewDisplayLists();
+
+    objectIndex = std::move(newIndex);
+    objectLoaded.assign(objectIndex.objects.size(), false);
+    for (size_t i : present) {
+        objectLoaded[i] = true;
+    }
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "Modèle rechargé en " << elapsed.count() << " ms : " << toParse.size() << " objets réanalysés, "
+              << keptMeshes << " meshes conservés, " << droppedMeshes << " remplacés ou supprimés" << std::endl;
+    requestRedisplay();
+}
+
+// Appelée à chaque passage dans idle() : recharge une fois le fichier stable
+void pollModelChanges() {
+    if (!modelWatcher.isWatching()) {
+        return;
+    }
+    if (modelWatcher.poll()) {
+        reloadPending = true;
+        lastModelChange = std::chrono::steady_clock::now();
+    }
+    auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastModelChange);
+    if (reloadPending && !streamingActive && quiet.count() >= kReloadDelayMs) {
+        reloadPending = false;
+        reloadChangedObjects();
+    }
+}
+
+// Démarre l'analyse du modèle en arrière-plan ; la scène est vide et se remplit au fil de l'eau
+void startStreamingModel(const std::string& path) {
+    ownedScene.reset(createScene(std::vector<MeshView>()));
+    scene = ownedScene.get();
+    streamStartTime = std::chrono::steady_clock::now();
+    streamingActive = true;
+    streamLoader.start(path);
+}
+
+// Démarre la lecture groupée et l'analyse des pièces ; la scène se remplit au fil de l'eau
+void startLoadingParts(const std::vector<std::string>& paths) {
+    ownedScene.reset(createScene(std::vector<MeshView>()));
+    scene = ownedScene.get();
+    streamStartTime = std::chrono::steady_clock::now();
+    streamingActive = true;
+    loadingParts = true;
+    partsLoader.start(paths);
+}
+
+// Ajoute à la scène les meshes publiés par les threads d'analyse depuis le dernier appel
+void pollStreamedMeshes() {
+    if (!streamingActive) {
+        return;
+    }
+    bool finished = loadingParts ? partsLoader.isFinished() : streamLoader.isFinished();
+    std::vector<ObjMesh> meshes = loadingParts ? partsLoader.takeReady() : streamLoader.takeReady();
+
+    if (!meshes.empty()) {
+        unsigned int first = scene->mNumMeshes;
+        std::vector<MeshView> views;
+        for (const ObjMesh& mesh : meshes) {
+            views.push_back(mesh.view());
+        }
+        appendMeshes(ownedScene.get(), views);
+
+        for (unsigned int i = first; i < scene->mNumMeshes; ++i) {
+            initMeshState(i);
+            meshAABBs[i] = calculateMeshAABB(scene->mMeshes[i]);
+        }
+        compactNewMeshes();
+        uploadNewMeshes();
+        compileNewDisplayLists();
+        if (first == 0) {
+            auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - streamStartTime);
+            std::cout << "Premier mesh disponible après " << elapsed.count() << " ms" << std::endl;
+        }
+        cameraDistance = calculateInitialDistance(meshAABBs);
+        requestRedisplay();
+    }
+
+    if (finished) {
+        streamingActive = false;
+        std::string error = loadingParts ? partsLoader.error() : streamLoader.error();
+        if (loadingParts) {
+            BatchReadStats stats = partsLoader.readStats();
+            std::cout << "Lecture de " << stats.filesRead << " fichiers (" << stats.bytesRead / 1024 << " Ko) par "
+                      << (stats.usedIoUring ? "io_uring" : "pread") << " en " << stats.requests << " requêtes" << std::endl;
+        }
+        if (!error.empty()) {
+            std::cerr << "Erreur de chargement du modèle : " << error << std::endl;
+        }
+        if (error.empty() || loadingParts) {
+            auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - streamStartTime);
+            std::cout << "Modèle chargé en " << elapsed.count() << " ms : " << scene->mNumMeshes << " meshes" << std::endl;
+        }
+    }
+}
+
+// Dessine une primitive glTF sans tampons GPU (--immediate, listes d'affichage) avec des tableaux de
+// sommets pointant dans le fichier projeté, dans sa transformation de noeud ; les indices 8/16/32 bits
+// sont passés tels quels
+void drawGlbPrimitive(const GlbPrimitive& primitive, bool withAttributes) {
+    glPushMatrix();
+    glMultMatrixf(primitive.transform);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, static_cast<GLsizei>(primitive.positions.stride), primitive.positions.data);
+    if (withAttributes && primitive.normals.data) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, static_cast<GLsizei>(primitive.normals.stride), primitive.normals.data);
+    }
+    if (withAttributes && primitive.texcoords.data) {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, static_cast<GLsizei>(primitive.texcoords.stride), primitive.texcoords.data);
+    }
+    if (primitive.indices.data) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(primitive.indices.count), primitive.indices.componentType,
+                       primitive.indices.data);
+    } else {
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(primitive.positions.count));
+    }
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+}
+
+// Dessine un mesh indexé (mode mémoire réduite, cache projeté) avec des tableaux de sommets et glDrawElements
+void drawMeshView(const MeshView& mesh, bool withAttributes) {
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, mesh.positions);
+    if (withAttributes && mesh.normals) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, 0, mesh.normals);
+    }
+    if (withAttributes && mesh.texcoords) {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, 0, mesh.texcoords);
+    }
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT, mesh.indices);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// Dessine un mesh compact en décodant ses sommets à la volée (--immediate, listes d'affichage)
+void drawCompactMesh(const CompactMesh& mesh, bool withAttributes) {
+    glBegin(GL_TRIANGLES);
+    for (unsigned int index : mesh.indices) {
+        float value[3];
+        if (withAttributes && mesh.hasNormals) {
+            mesh.decodeNormal(index, value);
+            glNormal3fv(value);
+        }
+        if (withAttributes && mesh.hasTexcoords) {
+            mesh.decodeTexcoord(index, value);
+            glTexCoord2fv(value);
+        }
+        mesh.decodePosition(index, value);
+        glVertex3fv(value);
+    }
+    glEnd();
+}
+
+// Émet les triangles d'un mesh, depuis sa liste d'affichage, ses tampons GPU, sa forme compacte,
+// son prototype ou l'aiMesh
+void drawMeshGeometry(int meshIndex, bool withAttributes) {
+    auto instance = meshInstances.find(meshIndex);
+    if (instance != meshInstances.end()) {
+        glPushMatrix();
+        glMultMatrixf(instance->second.transform);
+        drawMeshGeometry(static_cast<int>(instance->second.prototype), withAttributes);
+        glPopMatrix();
+        return;
+    }
+    auto list = displayLists.find(meshIndex);
+    if (list != displayLists.end()) {
+        glCallList(list->second);
+        return;
+    }
+    auto gpu = gpuMeshes.find(meshIndex);
+    if (gpu != gpuMeshes.end()) {
+        auto glb = glbMeshes.find(meshIndex);
+        if (glb != glbMeshes.end()) {
+            glPushMatrix();
+            glMultMatrixf(glbModel.primitives()[glb->second].transform);
+            drawGpuMesh(gpu->second, withAttributes);
+            glPopMatrix();
+        } else {
+            drawGpuMesh(gpu->second, withAttributes);
+        }
+        return;
+    }
+    auto compact = compactMeshes.find(meshIndex);
+    if (compact != compactMeshes.end()) {
+        drawCompactMesh(compact->second, withAttributes);
+        return;
+    }
+    auto lean = leanMeshes.find(meshIndex);
+    if (lean != leanMeshes.end()) {
+        drawMeshView(lean->second.view(), withAttributes);
+        return;
+    }
+    auto cached = cachedMeshes.find(meshIndex);
+    if (cached != cachedMeshes.end()) {
+        drawMeshView(sceneCache.mesh(cached->second), withAttributes);
+        return;
+    }
+    auto glb = glbMeshes.find(meshIndex);
+    if (glb != glbMeshes.end()) {
+        drawGlbPrimitive(glbModel.primitives()[glb->second], withAttributes);
+        return;
+    }
+    auto arena = arenaMeshes.find(meshIndex);
+    if (arena != arenaMeshes.end()) {
+        drawMeshView(geometryArena.view(arena->second), withAttributes);
+        return;
+    }
 
-        meshVisibility[i] = true;
+    const aiMesh* mesh = scene->mMeshes[meshIndex];
+    glBegin(GL_TRIANGLES);
+    for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
+        const aiFace& face = mesh->mFaces[j];
+        for (unsigned int k = 0; k < face.mNumIndices; k++) {
+            unsigned int index = face.mIndices[k];
+            if (withAttributes && mesh->HasNormals()) {
+                aiVector3D normal = mesh->mNormals[index];
+                glNormal3f(normal.x, normal.y, normal.z);
+            }
+            if (withAttributes && mesh->HasTextureCoords(0)) {
+                aiVector3D texCoord = mesh->mTextureCoords[0][index];
+                glTexCoord2f(texCoord.x, texCoord.y);
+            }
+            aiVector3D vertex = mesh->mVertices[index];
+            glVertex3f(vertex.x, vertex.y, vertex.z);
+        }
+    }
+    glEnd();
+}
+
+// Matrice de la caméra, appliquée par display() et par la sélection
+void cameraViewMatrix(float view[16]) {
+    matrixIdentity(view);
+    matrixTranslate(view, 0.0f, 0.0f, -cameraDistance);
+    matrixRotate(view, cameraAngleX, 1.0f, 0.0f, 0.0f);
+    matrixRotate(view, cameraAngleY, 0.0f, 1.0f, 0.0f);
+    matrixTranslate(view, -cameraPosX, -cameraPosY, 0.0f);
+}
 
-        GLfloat defaultColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-        std::copy(defaultColor, defaultColor + 4, meshColors[i]);
+void cameraProjectionMatrix(float projection[16], float aspect) {
+    matrixIdentity(projection);
+    matrixPerspective(projection, 45.0f, aspect, 1.0f, 100.0f);
+}
 
-        meshPositions[i] = aiVector3D(0.0f, 0.0f, 0.0f);
-        meshRotations[i] = 0.0f; // Initialize rotation
+// Position et rotation propres au mesh, comme les applique renderNode()
+void meshModelMatrix(int meshIndex, float model[16]) {
+    matrixIdentity(model);
+    const aiVector3D& position = meshPositions[meshIndex];
+    matrixTranslate(model, position.x, position.y, position.z);
+    matrixRotate(model, meshRotations[meshIndex], 0.0f, 1.0f, 0.0f);
+}
+
+// Vrai si la boîte englobante du mesh, placé par meshModelMatrix(), sort du volume de viewProjection
+bool meshOutsideView(int meshIndex, const float viewProjection[16]) {
+    auto found = meshAABBs.find(meshIndex);
+    if (found == meshAABBs.end()) {
+        return false;
+    }
+    float mvp[16], model[16];
+    std::copy(viewProjection, viewProjection + 16, mvp);
+    meshModelMatrix(meshIndex, model);
+    matrixMultiply(mvp, model);
+    const AABB& aabb = found->second;
+    const float min[3] = {aabb.min.x, aabb.min.y, aabb.min.z}, max[3] = {aabb.max.x, aabb.max.y, aabb.max.z};
+    return boxOutsideFrustum(mvp, min, max);
+}
+
+// Géométrie d'un mesh pour les chemins sur le processeur, quelle que soit sa forme, lue en place ou dans
+// cpuMeshes ; `model` reçoit en plus la transformation de l'instance ou du noeud glTF. Les meshes compacts
+// sont décodés dans `scratch` à chaque appel : les garder décodés annulerait le gain de mémoire.
+// Faux si la géométrie n'est plus que sur le GPU (--lean-memory avec tampons GPU).
+bool cpuMeshGeometry(int meshIndex, float model[16], ObjMesh& scratch, MeshView& view) {
+    auto instance = meshInstances.find(meshIndex);
+    if (instance != meshInstances.end()) {
+        matrixMultiply(model, instance->second.transform);
+        return cpuMeshGeometry(static_cast<int>(instance->second.prototype), model, scratch, view);
     }
-     for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-        aiMesh* mesh = scene->mMeshes[i];
-        meshAABBs[i] = calculateMeshAABB(mesh);
+    auto lean = leanMeshes.find(meshIndex);
+    if (lean != leanMeshes.end()) {
+        view = lean->second.view();
+        return true;
     }
-    cameraDistance = calculateInitialDistance(scene);
+    auto cached = cachedMeshes.find(meshIndex);
+    if (cached != cachedMeshes.end()) {
+        view = sceneCache.mesh(cached->second);
+        return true;
+    }
+    auto arena = arenaMeshes.find(meshIndex);
+    if (arena != arenaMeshes.end()) {
+        view = geometryArena.view(arena->second);
+        return true;
+    }
+    auto compact = compactMeshes.find(meshIndex);
+    if (compact != compactMeshes.end()) {
+        const CompactMesh& source = compact->second;
+        scratch.positions.resize(source.vertices.size() * 3);
+        scratch.normals.resize(source.hasNormals ? source.vertices.size() * 3 : 0);
+        for (unsigned int i = 0; i < source.vertices.size(); ++i) {
+            source.decodePosition(i, &scratch.positions[size_t(i) * 3]);
+            if (source.hasNormals) {
+                source.decodeNormal(i, &scratch.normals[size_t(i) * 3]);
+            }
+        }
+        view = scratch.view();
+        view.indices = source.indices.data();
+        view.indexCount = source.indices.size();
+        return true;
+    }
+
+    auto glb = glbMeshes.find(meshIndex);
+    if (glb != glbMeshes.end()) {
+        matrixMultiply(model, glbModel.primitives()[glb->second].transform);
+    }
+    const aiMesh* source = scene->mMeshes[meshIndex];
+    if (glb == glbMeshes.end() && source->mNumVertices == 0) {
+        return false;
+    }
+    auto flat = cpuMeshes.find(meshIndex);
+    if (flat == cpuMeshes.end()) {
+        ObjMesh& mesh = cpuMeshes[meshIndex];
+        if (glb != glbMeshes.end()) {
+            const GlbPrimitive& primitive = glbModel.primitives()[glb->second];
+            mesh.positions.resize(primitive.positions.count * 3);
+            mesh.normals.resize(primitive.normals.data ? primitive.positions.count * 3 : 0);
+            for (size_t i = 0; i < primitive.positions.count; ++i) {
+                std::memcpy(&mesh.positions[i * 3], primitive.positions.data + i * primitive.positions.stride, 3 * sizeof(float));
+                if (primitive.normals.data) {
+                    std::memcpy(&mesh.normals[i * 3], primitive.normals.data + i * primitive.normals.stride, 3 * sizeof(float));
+                }
+            }
+            const GlbStream& indices = primitive.indices;
+            mesh.indices.resize(indices.data ? indices.count : primitive.positions.count);
+            for (size_t i = 0; i < mesh.indices.size(); ++i) {
+                const unsigned char* p = indices.data ? indices.data + i * indices.stride : nullptr;
+                if (!p) {
+                    mesh.indices[i] = static_cast<unsigned int>(i);
+                } else if (indices.componentType == GL_UNSIGNED_BYTE) {
+                    mesh.indices[i] = *p;
+                } else if (indices.componentType == GL_UNSIGNED_SHORT) {
+                    uint16_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    mesh.indices[i] = value;
+                } else {
+                    std::memcpy(&mesh.indices[i], p, sizeof(uint32_t));
+                }
+            }
+        } else {
+            // Seuls les indices sont aplatis (faces en éventail, comme extractMesh)
+            for (unsigned int f = 0; f < source->mNumFaces; ++f) {
+                const aiFace& face = source->mFaces[f];
+                for (unsigned int k = 2; k < face.mNumIndices; ++k) {
+                    mesh.indices.insert(mesh.indices.end(), {face.mIndices[0], face.mIndices[k - 1], face.mIndices[k]});
+                }
+            }
+        }
+        flat = cpuMeshes.find(meshIndex);
+    }
+    view = flat->second.view();
+    if (glb == glbMeshes.end()) {
+        view.name = source->mName.C_Str();
+        view.positions = &source->mVertices[0].x;
+        view.normals = source->HasNormals() ? &source->mNormals[0].x : nullptr;
+        view.vertexCount = source->mNumVertices;
+    }
+    return true;
 }
 
 // Fonction récursive pour dessiner le modèle
@@ -144,6 +1487,10 @@ void renderNode(const aiNode* node, const aiScene* scene, bool selectionMode = f
             continue;
         }
 
+        if (useFrustumCulling && meshOutsideView(meshIndex, frameViewProjection)) {
+            continue;
+        }
+
         if (selectionMode) {
             glPushName(meshIndex);
         }
@@ -152,31 +1499,12 @@ void renderNode(const aiNode* node, const aiScene* scene, bool selectionMode = f
             glColor4fv(meshColors[meshIndex]);
         }
 
-        aiMesh* mesh = scene->mMeshes[meshIndex];
-
         glPushMatrix();
         aiVector3D position = meshPositions[meshIndex];
         glTranslatef(position.x, position.y, position.z);
         glRotatef(meshRotations[meshIndex], 0.0f, 1.0f, 0.0f); // Apply Rotation
 
-        glBegin(GL_TRIANGLES);
-        for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
-            aiFace face = mesh->mFaces[j];
-            for (unsigned int k = 0; k < face.mNumIndices; k++) {
-                unsigned int index = face.mIndices[k];
-                if (mesh->HasNormals()) {
-                    aiVector3D normal = mesh->mNormals[index];
-                    glNormal3f(normal.x, normal.y, normal.z);
-                }
-                if (mesh->HasTextureCoords(0)) {
-                    aiVector3D texCoord = mesh->mTextureCoords[0][index];
-                    glTexCoord2f(texCoord.x, texCoord.y);
-                }
-                aiVector3D vertex = mesh->mVertices[index];
-                glVertex3f(vertex.x, vertex.y, vertex.z);
-            }
-        }
-        glEnd();
+        drawMeshGeometry(meshIndex, true);
 
         glPopMatrix();
 
@@ -196,15 +1524,8 @@ void initOpenGL() {
     glEnable(GL_LIGHTING);
     glEnable(GL_COLOR_MATERIAL);
 
-    GLfloat lightPosition[NUM_LIGHTS][4] = {
-        {0.0f, -1.0f, 0.0f, 0.0f},
-        {0.0f, 1.0f, 0.0f, 0.0f},
-        {-1.0f, 0.0f, 0.0f, 0.0f},
-        {1.0f, 0.0f, 0.0f, 0.0f}
-    };
-
     for (int i = 0; i < NUM_LIGHTS; ++i) {
-        glLightfv(GL_LIGHT0 + i, GL_POSITION, lightPosition[i]);
+        glLightfv(GL_LIGHT0 + i, GL_POSITION, lightPositions[i]);
         glLightfv(GL_LIGHT0 + i, GL_DIFFUSE, lightColors[i]);
         glLightfv(GL_LIGHT0 + i, GL_SPECULAR, lightColors[i]);
         glEnable(GL_LIGHT0 + i);
@@ -227,15 +1548,15 @@ void mouseWheel(int wheel, int direction, int x, int y) {
     glutPostRedisplay();
 }
 
-// Fonction d'affichage
+// Fonction d'affichage (fenêtre GLUT ou framebuffer hors écran)
 void display() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glLoadIdentity();
 
-    glTranslatef(0.0f, 0.0f, -cameraDistance);
-    glRotatef(cameraAngleX, 1.0f, 0.0f, 0.0f);
-    glRotatef(cameraAngleY, 0.0f, 1.0f, 0.0f);
-    glTranslatef(-cameraPosX, -cameraPosY, 0.0f);
+    float view[16];
+    cameraViewMatrix(view);
+    glLoadMatrixf(view);
+    cameraProjectionMatrix(frameViewProjection, float(viewportWidth) / float(viewportHeight));
+    matrixMultiply(frameViewProjection, view);
 
     if (scene && scene->mRootNode) {
         renderNode(scene->mRootNode, scene);
@@ -251,7 +1572,9 @@ void display() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
 
-    glutSwapBuffers();
+    if (!headless) {
+        glutSwapBuffers();
+    }
 }
 
 void updateAnimation() {
@@ -270,46 +1593,96 @@ void updateAnimation() {
 }
 
 
-// Fonction de sélection d'un objet
-void selectObject(int x, int y, bool addToSelection) {
-    GLuint buffer[512];
+// Fonction appelée lorsque GLUT n'a pas d'événement à traiter
+void idle() {
+    pollStreamedMeshes();
+    pollModelChanges();
+    updateAnimation();
+}
+
+// Sélection sur le processeur : les meshes visibles sont projetés avec une projection réduite à la zone
+// de 5x5 pixels sous le curseur (comme gluPickMatrix) ; un triangle qui reste après découpage exact
+// touche la zone, et le plus proche l'emporte. Faux si un mesh candidat n'a plus de géométrie en mémoire.
+bool pickMeshCpu(const aiNode* node, const float viewProjection[16], ObjMesh& scratch, std::vector<float>& clip,
+                 std::vector<uint8_t>& outcodes, std::vector<ClippedTriangle>& triangles, int& picked, float& nearest) {
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        const int meshIndex = node->mMeshes[i];
+        if (!meshVisibility[meshIndex] || meshOutsideView(meshIndex, viewProjection)) {
+            continue;
+        }
+        float model[16];
+        meshModelMatrix(meshIndex, model);
+        MeshView mesh;
+        if (!cpuMeshGeometry(meshIndex, model, scratch, mesh)) {
+            if (gpuMeshes.count(meshIndex) || displayLists.count(meshIndex)) {
+                return false;
+            }
+            continue;
+        }
+        float mvp[16];
+        std::copy(viewProjection, viewProjection + 16, mvp);
+        matrixMultiply(mvp, model);
+        clip.resize(mesh.vertexCount * 4);
+        outcodes.resize(mesh.vertexCount);
+        if (transformVertices(mvp, mesh.positions, mesh.vertexCount, clip.data(), outcodes.data()).all) {
+            continue;
+        }
+        triangles.clear();
+        clipTriangles(clip.data(), outcodes.data(), mesh.indices, mesh.indexCount / 3, 1, 1, 1.0f, triangles);
+        for (const ClippedTriangle& triangle : triangles) {
+            const float depth = std::min({triangle.z[0], triangle.z[1], triangle.z[2]});
+            if (depth < nearest) {
+                nearest = depth;
+                picked = meshIndex;
+            }
+        }
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        if (!pickMeshCpu(node->mChildren[i], viewProjection, scratch, clip, outcodes, triangles, picked, nearest)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sélection par OpenGL (GL_SELECT), quand la géométrie n'est plus que sur le GPU : mêmes meshes et
+// mêmes transformations que pickMeshCpu, le plus proche l'emporte ; -1 si rien n'est touché
+int pickMeshGl(int x, int y) {
+    // Un enregistrement par mesh touché : nombre de noms, profondeurs min et max, puis le nom
+    std::vector<GLuint> buffer(4 * size_t(scene->mNumMeshes) + 4);
     GLint viewport[4];
 
     glGetIntegerv(GL_VIEWPORT, viewport);
-    glSelectBuffer(512, buffer);
+    glSelectBuffer(static_cast<GLsizei>(buffer.size()), buffer.data());
     glRenderMode(GL_SELECT);
 
     glInitNames();
     glPushName(0);
 
+    float projection[16], view[16];
+    cameraProjectionMatrix(projection, (float)viewport[2] / (float)viewport[3]);
+    cameraViewMatrix(view);
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
     gluPickMatrix(x, viewport[3] - y, 5.0, 5.0, viewport);
-    gluPerspective(45.0, (double)viewport[2] / (double)viewport[3], 0.1, 100.0);
+    glMultMatrixf(projection);
     glMatrixMode(GL_MODELVIEW);
 
     glPushMatrix();
-    glLoadIdentity();
-    glTranslatef(0.0f, 0.0f, -cameraDistance);
-    glRotatef(cameraAngleX, 1.0f, 0.0f, 0.0f);
-    glRotatef(cameraAngleY, 0.0f, 1.0f, 0.0f);
-    glTranslatef(-cameraPosX, -cameraPosY, 0.0f);
+    glLoadMatrixf(view);
 
     for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-        glLoadName(i);
-
-        aiMesh* mesh = scene->mMeshes[i];
-        glBegin(GL_TRIANGLES);
-        for (unsigned int j = 0; j < mesh->mNumFaces; ++j) {
-            aiFace face = mesh->mFaces[j];
-            for (unsigned int k = 0; k < face.mNumIndices; ++k) {
-                unsigned int index = face.mIndices[k];
-                aiVector3D vertex = mesh->mVertices[index];
-                glVertex3f(vertex.x, vertex.y, vertex.z);
-            }
+        if (!meshVisibility[i]) {
+            continue;
         }
-        glEnd();
+        glLoadName(i);
+        float model[16];
+        meshModelMatrix(i, model);
+        glPushMatrix();
+        glMultMatrixf(model);
+        drawMeshGeometry(i, false);
+        glPopMatrix();
     }
 
     glPopMatrix();
@@ -318,10 +1691,48 @@ void selectObject(int x, int y, bool addToSelection) {
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
 
-    GLint hits = glRenderMode(GL_RENDER);
-    if (hits > 0) {
-        int selectedIdx = buffer[3];
+    const GLint hits = glRenderMode(GL_RENDER);
+    int picked = -1;
+    GLuint nearest = ~0u;
+    size_t record = 0;
+    for (GLint hit = 0; hit < hits && record + 3 < buffer.size(); ++hit) {
+        const GLuint names = buffer[record];
+        if (names > 0 && (picked < 0 || buffer[record + 1] < nearest)) {
+            nearest = buffer[record + 1];
+            picked = static_cast<int>(buffer[record + 3]);
+        }
+        record += 3 + names;
+    }
+    return picked;
+}
 
+// Fonction de sélection d'un objet
+void selectObject(int x, int y, bool addToSelection) {
+    // Zone de 5x5 pixels centrée sur le curseur, étirée sur tout le volume de vue
+    const float pickSize = 5.0f;
+    const float pickX = float(x), pickY = float(viewportHeight - y);
+    float viewProjection[16], projection[16], view[16];
+    matrixIdentity(viewProjection);
+    matrixTranslate(viewProjection, (viewportWidth - 2.0f * pickX) / pickSize, (viewportHeight - 2.0f * pickY) / pickSize, 0.0f);
+    const float scale[16] = {viewportWidth / pickSize, 0, 0, 0, 0, viewportHeight / pickSize, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    matrixMultiply(viewProjection, scale);
+    cameraProjectionMatrix(projection, float(viewportWidth) / float(viewportHeight));
+    matrixMultiply(viewProjection, projection);
+    cameraViewMatrix(view);
+    matrixMultiply(viewProjection, view);
+
+    int selectedIdx = -1;
+    float nearest = FLT_MAX;
+    ObjMesh scratch;
+    std::vector<float> clip;
+    std::vector<uint8_t> outcodes;
+    std::vector<ClippedTriangle> triangles;
+    if (!scene->mRootNode ||
+        !pickMeshCpu(scene->mRootNode, viewProjection, scratch, clip, outcodes, triangles, selectedIdx, nearest)) {
+        selectedIdx = pickMeshGl(x, y);
+    }
+
+    if (selectedIdx >= 0) {
         if (addToSelection) {
             if (selectedMeshes.find(selectedIdx) != selectedMeshes.end()) {
                 selectedMeshes.erase(selectedIdx);
@@ -608,6 +2019,9 @@ void keyboard(unsigned char key, int x, int y) {
                 glutPostRedisplay();
             }
             break;
+        case 'l':
+            loadRemainingObjects();
+            break;
         case 27:
             exit(0);
     }
@@ -616,21 +2030,277 @@ void keyboard(unsigned char key, int x, int y) {
 
 // Redimensionner la fenêtre
 void reshape(int w, int h) {
+    viewportWidth = std::max(w, 1);
+    viewportHeight = std::max(h, 1);
     glViewport(0, 0, w, h);
+    float projection[16];
+    cameraProjectionMatrix(projection, float(viewportWidth) / float(viewportHeight));
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(45.0, (double)w / (double)h, 1.0, 100.0);
+    glLoadMatrixf(projection);
     glMatrixMode(GL_MODELVIEW);
 }
 
+// Meshes visibles dans l'ordre de renderNode(), avec leur couleur et leur position
+void collectSoftwareDraws(const aiNode* node, std::vector<SoftDraw>& draws, std::deque<ObjMesh>& storage) {
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        const int meshIndex = node->mMeshes[i];
+        if (!meshVisibility[meshIndex]) {
+            continue;
+        }
+        if (useFrustumCulling && meshOutsideView(meshIndex, frameViewProjection)) {
+            continue;
+        }
+        SoftDraw draw;
+        meshModelMatrix(meshIndex, draw.model);
+        std::copy(meshColors[meshIndex], meshColors[meshIndex] + 4, draw.color);
+        storage.emplace_back();
+        if (cpuMeshGeometry(meshIndex, draw.model, storage.back(), draw.mesh)) {
+            draws.push_back(draw);
+        }
+        if (storage.back().positions.empty()) {
+            storage.pop_back(); // géométrie lue en place
+        }
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        collectSoftwareDraws(node->mChildren[i], draws, storage);
+    }
+}
+
+// Équivalent logiciel de display() : même caméra, même projection que reshape(), mêmes lumières
+void renderSoftware(SoftRasterizer& rasterizer, std::vector<SoftDraw>& draws, std::deque<ObjMesh>& storage, SoftRenderStats* stats) {
+    SoftRenderOptions options;
+    cameraViewMatrix(options.view);
+    cameraProjectionMatrix(options.projection, float(rasterizer.width()) / float(rasterizer.height()));
+    if (draws.empty() && scene && scene->mRootNode) {
+        std::copy(options.projection, options.projection + 16, frameViewProjection);
+        matrixMultiply(frameViewProjection, options.view);
+        collectSoftwareDraws(scene->mRootNode, draws, storage);
+    }
+    for (int i = 0; i < NUM_LIGHTS; ++i) {
+        if (lightEnabled[i]) {
+            const float* p = lightPositions[i];
+            const float length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            options.lights.push_back({{p[0] / length, p[1] / length, p[2] / length},
+                                      {lightColors[i][0], lightColors[i][1], lightColors[i][2]}});
+        }
+    }
+    const float clearColor[3] = {0.1f, 0.1f, 0.1f}; // celle de initOpenGL()
+    std::copy(clearColor, clearColor + 3, options.clearColor);
+    rasterizer.render(draws, options, stats);
+}
+
+// Dessine la scène chargée hors écran et écrit l'image ; avec plusieurs images, affiche le temps moyen
+int renderHeadless() {
+    while (streamingActive) {
+        pollStreamedMeshes();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    cameraDistance = requestedCameraDistance > 0.0f ? requestedCameraDistance : calculateInitialDistance(meshAABBs);
+
+    // La première image (mise en place, géométrie du rendu logiciel) n'est pas chronométrée
+    SoftRasterizer rasterizer;
+    std::vector<SoftDraw> draws;
+    std::deque<ObjMesh> storage;
+    SoftRenderStats stats;
+    if (useSoftwareRenderer) {
+        rasterizer.resize(headlessWidth, headlessHeight);
+        renderSoftware(rasterizer, draws, storage, &stats);
+    } else {
+        reshape(headlessWidth, headlessHeight);
+        display();
+        glFinish();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 1; frame < headlessFrames; ++frame) {
+        if (useSoftwareRenderer) {
+            renderSoftware(rasterizer, draws, storage, &stats);
+        } else {
+            display();
+        }
+    }
+    if (!useSoftwareRenderer) {
+        glFinish();
+    }
+    if (headlessFrames > 1) {
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        std::cout << "Rendu hors écran : " << headlessFrames - 1 << " images, " << elapsed.count() / (headlessFrames - 1)
+                  << " ms par image" << std::endl;
+    }
+    if (useSoftwareRenderer) {
+        std::cout << "Rendu logiciel : " << stats.trianglesIn << " triangles, " << stats.trianglesBinned
+                  << " après rejet et découpage, " << stats.tiles << " tuiles, " << workerCount() << " threads" << std::endl;
+    }
+
+    std::vector<uint8_t> pixels;
+    if (useSoftwareRenderer) {
+        pixels = rasterizer.pixels();
+    } else {
+        headlessContext.readPixels(pixels);
+    }
+    std::string error;
+    const bool png = headlessOutput.size() >= 4 && headlessOutput.compare(headlessOutput.size() - 4, 4, ".png") == 0;
+    const bool written = png ? writePng(headlessOutput, headlessWidth, headlessHeight, pixels, &error)
+                             : writePpm(headlessOutput, headlessWidth, headlessHeight, pixels, &error);
+    if (!written) {
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Image écrite : " << headlessOutput << " (" << headlessWidth << "x" << headlessHeight << ")" << std::endl;
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv) {
-    glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
-    glutInitWindowSize(800, 600);
-    glutCreateWindow("3D Drone Viewer");
+    // Sans fenêtre, GLUT n'est pas initialisé (pas de serveur d'affichage nécessaire)
+    for (int i = 1; i < argc; ++i) {
+        headless = headless || std::string(argv[i]).rfind("--headless=", 0) == 0;
+    }
+    if (!headless) {
+        glutInit(&argc, argv);
+        glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+        glutInitWindowSize(800, 600);
+        glutCreateWindow("3D Drone Viewer");
+        if (!gladLoadGL()) {
+            std::cerr << "Impossible de charger les fonctions OpenGL" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    initOpenGL();
-    loadModel(modelPath);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--parallel-obj") {
+            modelLoader = ModelLoader::ParallelObj;
+        } else if (arg == "--mmap-obj") {
+            modelLoader = ModelLoader::MappedObj;
+        } else if (arg == "--arena-obj") {
+            modelLoader = ModelLoader::ArenaObj;
+        } else if (arg == "--mesh-cache") {
+            useMeshCache = true;
+        } else if (arg == "--write-pack") {
+            useWritePack = true;
+        } else if (arg == "--weld") {
+            useWeld = true;
+        } else if (arg.rfind("--weld=", 0) == 0) {
+            useWeld = true;
+            weldEpsilon = std::strtof(arg.c_str() + 7, nullptr);
+        } else if (arg == "--profile-load") {
+            loadProfiler.setEnabled(true);
+        } else if (arg.rfind("--profile-load=", 0) == 0) {
+            loadProfiler.setEnabled(true);
+            profileOutputPath = arg.substr(15);
+        } else if (arg == "--optimize-indices") {
+            useIndexOptimization = true;
+        } else if (arg == "--instance-meshes") {
+            useInstancing = true;
+        } else if (arg == "--compact-vertices") {
+            useCompactVertices = true;
+        } else if (arg == "--immediate") {
+            useGpuBuffers = false;
+        } else if (arg == "--no-culling") {
+            useFrustumCulling = false;
+        } else if (arg == "--display-lists") {
+            useDisplayLists = true;
+            useGpuBuffers = false;
+        } else if (arg.rfind("--headless=", 0) == 0) {
+            headlessOutput = arg.substr(11);
+        } else if (arg.rfind("--size=", 0) == 0) {
+            if (std::sscanf(arg.c_str() + 7, "%dx%d", &headlessWidth, &headlessHeight) != 2 || headlessWidth <= 0 ||
+                headlessHeight <= 0) {
+                std::cerr << "--size : format attendu LxH" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (arg.rfind("--camera=", 0) == 0) {
+            if (std::sscanf(arg.c_str() + 9, "%f,%f,%f", &cameraAngleX, &cameraAngleY, &requestedCameraDistance) < 2) {
+                std::cerr << "--camera : format attendu angleX,angleY[,distance]" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (arg == "--software") {
+            useSoftwareRenderer = true;
+        } else if (arg.rfind("--frames=", 0) == 0) {
+            headlessFrames = std::max(1, std::atoi(arg.c_str() + 9));
+        } else if (arg == "--lean-memory") {
+            useLeanMemory = true;
+        } else if (arg == "--watch") {
+            useHotReload = true;
+        } else if (arg == "--stream") {
+            useStreaming = true;
+        } else if (arg.rfind("--objects=", 0) == 0) {
+            std::string list = arg.substr(10);
+            for (size_t start = 0; start <= list.size();) {
+                size_t comma = std::min(list.find(',', start), list.size());
+                if (comma > start) {
+                    requestedObjects.push_back(list.substr(start, comma - start));
+                }
+                start = comma + 1;
+            }
+        } else {
+            modelPaths.push_back(arg);
+        }
+    }
+    if (!modelPaths.empty()) {
+        modelPath = modelPaths.front();
+    }
+    if (isGlbPath(modelPath)) {
+        modelLoader = ModelLoader::Glb;
+    } else if (isStlPath(modelPath)) {
+        modelLoader = ModelLoader::Stl;
+    } else if (isPlyPath(modelPath)) {
+        modelLoader = ModelLoader::Ply;
+    }
+    if ((modelLoader == ModelLoader::ArenaObj || modelLoader == ModelLoader::Glb) &&
+        (useMeshCache || useWeld || useIndexOptimization || useInstancing || useCompactVertices || useWritePack || useHotReload)) {
+        // Ces traitements relisent et remplacent la géométrie des aiMesh, absente avec l'arène et le .glb
+        std::cerr << loaderName() << " : cache, fusion, optimisation, instances, sommets compacts, conteneur et "
+                     "rechargement à chaud ignorés" << std::endl;
+        useMeshCache = useWeld = useIndexOptimization = useInstancing = useCompactVertices = useWritePack = useHotReload = false;
+    }
+    if (useSoftwareRenderer && !headless) {
+        std::cerr << "--software : uniquement avec --headless" << std::endl;
+        useSoftwareRenderer = false;
+    }
+    if (useSoftwareRenderer) {
+        // Aucun contexte OpenGL : ni tampons GPU ni listes d'affichage
+        useGpuBuffers = useDisplayLists = false;
+    } else if (headless) {
+        std::string error;
+        if (!headlessContext.create(headlessWidth, headlessHeight, &error)) {
+            std::cerr << "Rendu hors écran impossible : " << error << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (headless && useHotReload) {
+        std::cerr << "--headless : rechargement à chaud ignoré" << std::endl;
+        useHotReload = false;
+    }
+    if (useGpuBuffers && !GLAD_GL_VERSION_1_5) {
+        std::cerr << "OpenGL 1.5 indisponible : dessin en mode immédiat" << std::endl;
+        useGpuBuffers = false;
+    }
+    if (useLeanMemory && useHotReload) {
+        // Le rechargement reprend les aiMesh inchangés de la scène, qui n'ont plus de géométrie
+        std::cerr << "--lean-memory : rechargement à chaud ignoré" << std::endl;
+        useHotReload = false;
+    }
+
+    if (!useSoftwareRenderer) {
+        initOpenGL();
+    }
+    if (modelPaths.size() > 1) {
+        startLoadingParts(modelPaths);
+    } else if (useStreaming) {
+        startStreamingModel(modelPath);
+    } else if (!requestedObjects.empty()) {
+        loadIndexedModel(modelPath);
+    } else {
+        loadModel(modelPath);
+    }
+    if (useHotReload && modelPaths.size() > 1) {
+        std::cerr << "Rechargement à chaud désactivé : plusieurs fichiers de modèle" << std::endl;
+    } else if (useHotReload) {
+        startWatchingModel(modelPath);
+    }
+    if (headless) {
+        return renderHeadless();
+    }
 
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
@@ -639,8 +2309,8 @@ int main(int argc, char** argv) {
     glutMotionFunc(mouseMotion);
     glutMouseWheelFunc(mouseWheel);
     
-    // Timer Function to drive the animation
-    glutIdleFunc(updateAnimation);
+    // Idle function: drives the animation and picks up streamed meshes
+    glutIdleFunc(idle);
 
     glutMainLoop();
 
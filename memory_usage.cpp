@@ -0,0 +1,41 @@
+#include "memory_usage.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Valeur en octets d'une ligne "Champ:   1234 kB" de /proc/self/status
+uint64_t readStatusField(const char* field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    const size_t length = std::strlen(field);
+    while (std::getline(status, line)) {
+        if (line.compare(0, length, field) == 0 && line.size() > length && line[length] == ':') {
+            return std::strtoull(line.c_str() + length + 1, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+uint64_t residentBytes() {
+    return readStatusField("VmRSS");
+}
+
+uint64_t peakResidentBytes() {
+    return readStatusField("VmHWM");
+}
+
+void releaseFreeMemory() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Mémoire résidente du processus (VmRSS) et son maximum depuis le démarrage (VmHWM), lues dans
+// /proc/self/status ; 0 si l'information n'est pas disponible.
+uint64_t residentBytes();
+uint64_t peakResidentBytes();
+
+// Rend au système la mémoire libre du tas (malloc_trim avec la glibc, sans effet ailleurs),
+// pour que la mémoire résidente mesurée après une libération reflète ce qui est encore utilisé
+void releaseFreeMemory();
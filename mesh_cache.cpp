@@ -0,0 +1,330 @@
+#include "mesh_cache.h"
+
+#include <sys/stat.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char kMagic[8] = {'M', 'E', 'S', 'H', 'C', 'A', 'C', 'H'};
+const uint32_t kByteOrderMark = 0x01020304;
+const uint64_t kAlignment = 16;
+
+const uint32_t kHasNormals = 1;
+const uint32_t kHasTexcoords = 2;
+
+// Options du chargement dans CacheHeader::pipelineFlags : bits 0-1, chargeur dans les bits 8-15
+const uint32_t kPipelineWeld = 1;
+const uint32_t kPipelineOptimizeIndices = 2;
+const int kPipelineLoaderShift = 8;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint32_t meshCount;
+    uint32_t pipelineFlags;
+    float weldEpsilon; // 0 sans fusion
+    uint32_t reserved;
+};
+
+struct CacheMeshEntry {
+    uint64_t nameOffset;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t positionsOffset;
+    uint64_t normalsOffset;
+    uint64_t texcoordsOffset;
+    uint64_t indicesOffset;
+    uint32_t nameLength;
+    uint32_t flags;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+static_assert(sizeof(CacheHeader) == 56, "format du cache modifié");
+static_assert(sizeof(CacheMeshEntry) == 88, "format du cache modifié");
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+bool inFile(uint64_t offset, uint64_t bytes, size_t fileSize) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+// Après une empreinte vérifiée, enregistre la nouvelle date de la source dans l'en-tête pour que les
+// ouvertures suivantes n'aient plus à relire toute la source. Sans effet si le cache n'est pas modifiable.
+void refreshSourceMtime(const std::string& cachePath, int64_t sourceMtime) {
+    std::fstream out(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (out) {
+        out.seekp(offsetof(CacheHeader, sourceMtime));
+        out.write(reinterpret_cast<const char*>(&sourceMtime), sizeof(sourceMtime));
+    }
+}
+
+uint32_t pipelineFlags(const MeshCacheOptions& options) {
+    return (options.weld ? kPipelineWeld : 0) | (options.optimizeIndices ? kPipelineOptimizeIndices : 0) |
+           (static_cast<uint32_t>(options.loader) << kPipelineLoaderShift);
+}
+
+} // namespace
+
+uint64_t hashBytes(const char* data, size_t size) {
+    const uint64_t kPrime = 0x9e3779b97f4a7c15ULL;
+    uint64_t h = size * kPrime;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ mix(word)) * kPrime;
+    }
+    uint64_t last = 0;
+    if (i < size) {
+        std::memcpy(&last, data + i, size - i);
+    }
+    h = (h ^ mix(last)) * kPrime;
+    return mix(h);
+}
+
+bool statSource(const std::string& path, uint64_t& size, int64_t& mtime, std::string* err) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        if (err) *err = "source introuvable : " + path;
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+#ifdef __APPLE__
+    mtime = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+std::string meshCachePath(const std::string& sourcePath) {
+    return sourcePath + ".meshcache";
+}
+
+bool hashFileContents(const std::string& path, uint64_t& hash, std::string* err) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    hash = hashBytes(file.data(), file.size());
+    return true;
+}
+
+bool writeMeshCache(const std::string& cachePath, const std::string& sourcePath, const ObjModel& model,
+                    const std::vector<MeshBounds>& bounds, const MeshCacheOptions& options, std::string* err) {
+    CacheHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kMeshCacheVersion;
+    header.byteOrder = kByteOrderMark;
+    header.meshCount = static_cast<uint32_t>(model.meshes.size());
+    header.pipelineFlags = pipelineFlags(options);
+    header.weldEpsilon = options.weld ? options.weldEpsilon : 0.0f;
+    if (!statSource(sourcePath, header.sourceSize, header.sourceMtime, err) ||
+        !hashFileContents(sourcePath, header.sourceHash, err)) {
+        return false;
+    }
+
+    // Disposition : en-tête, table des meshes, puis noms et tableaux alignés sur 16 octets
+    std::vector<CacheMeshEntry> entries(model.meshes.size());
+    uint64_t offset = sizeof(CacheHeader) + entries.size() * sizeof(CacheMeshEntry);
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        const ObjMesh& mesh = model.meshes[i];
+        CacheMeshEntry& entry = entries[i];
+        entry.vertexCount = mesh.vertexCount();
+        entry.indexCount = mesh.indices.size();
+        entry.flags = (mesh.normals.empty() ? 0 : kHasNormals) | (mesh.texcoords.empty() ? 0 : kHasTexcoords);
+        for (int k = 0; k < 3; ++k) {
+            entry.boundsMin[k] = bounds[i].min[k];
+            entry.boundsMax[k] = bounds[i].max[k];
+        }
+
+        entry.nameOffset = offset;
+        entry.nameLength = static_cast<uint32_t>(mesh.name.size());
+        offset = alignUp(offset + mesh.name.size());
+        entry.positionsOffset = offset;
+        offset = alignUp(offset + mesh.positions.size() * sizeof(float));
+        entry.normalsOffset = offset;
+        offset = alignUp(offset + mesh.normals.size() * sizeof(float));
+        entry.texcoordsOffset = offset;
+        offset = alignUp(offset + mesh.texcoords.size() * sizeof(float));
+        entry.indicesOffset = offset;
+        offset = alignUp(offset + mesh.indices.size() * sizeof(unsigned int));
+    }
+
+    // Écriture dans un fichier temporaire renommé à la fin, pour ne jamais laisser un cache partiel
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (err) *err = "impossible d'écrire " + tempPath;
+            return false;
+        }
+        uint64_t written = 0;
+        auto writeAt = [&](uint64_t position, const void* data, size_t bytes) {
+            static const char zeros[kAlignment] = {};
+            while (written < position) {
+                size_t pad = static_cast<size_t>(std::min<uint64_t>(position - written, kAlignment));
+                out.write(zeros, static_cast<std::streamsize>(pad));
+                written += pad;
+            }
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+
+        writeAt(0, &header, sizeof(header));
+        writeAt(sizeof(header), entries.data(), entries.size() * sizeof(CacheMeshEntry));
+        for (size_t i = 0; i < model.meshes.size(); ++i) {
+            const ObjMesh& mesh = model.meshes[i];
+            const CacheMeshEntry& entry = entries[i];
+            writeAt(entry.nameOffset, mesh.name.data(), mesh.name.size());
+            writeAt(entry.positionsOffset, mesh.positions.data(), mesh.positions.size() * sizeof(float));
+            writeAt(entry.normalsOffset, mesh.normals.data(), mesh.normals.size() * sizeof(float));
+            writeAt(entry.texcoordsOffset, mesh.texcoords.data(), mesh.texcoords.size() * sizeof(float));
+            writeAt(entry.indicesOffset, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+        }
+        writeAt(offset, nullptr, 0);
+        if (!out) {
+            if (err) *err = "erreur d'écriture de " + tempPath;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        if (err) *err = "impossible de renommer " + tempPath;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::open(const std::string& cachePath, const std::string& sourcePath, const MeshCacheOptions& options,
+                     std::string* err) {
+    meshes_.clear();
+    bounds_.clear();
+    if (!file_.open(cachePath, err)) {
+        return false;
+    }
+
+    CacheHeader header;
+    if (file_.size() < sizeof(header)) {
+        if (err) *err = "cache tronqué : " + cachePath;
+        return false;
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.byteOrder != kByteOrderMark) {
+        if (err) *err = "fichier de cache invalide : " + cachePath;
+        return false;
+    }
+    if (header.version != kMeshCacheVersion) {
+        if (err) *err = "version de cache obsolète : " + cachePath;
+        return false;
+    }
+    if (header.pipelineFlags != pipelineFlags(options) || header.weldEpsilon != (options.weld ? options.weldEpsilon : 0.0f)) {
+        if (err) *err = "cache écrit avec d'autres options de chargement (chargeur, --weld, --optimize-indices)";
+        return false;
+    }
+
+    // Taille et date identiques : cache valide. Sinon l'empreinte du contenu tranche
+    // (source recopiée ou simplement touchée).
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime, err)) {
+        return false;
+    }
+    if (sourceSize != header.sourceSize) {
+        if (err) *err = "la source a changé depuis l'écriture du cache";
+        return false;
+    }
+    if (sourceMtime != header.sourceMtime) {
+        uint64_t hash = 0;
+        if (!hashFileContents(sourcePath, hash, err)) {
+            return false;
+        }
+        if (hash != header.sourceHash) {
+            if (err) *err = "la source a changé depuis l'écriture du cache";
+            return false;
+        }
+        refreshSourceMtime(cachePath, sourceMtime);
+    }
+
+    const uint64_t tableBytes = uint64_t(header.meshCount) * sizeof(CacheMeshEntry);
+    if (!inFile(sizeof(header), tableBytes, file_.size())) {
+        if (err) *err = "cache tronqué : " + cachePath;
+        return false;
+    }
+    const char* base = file_.data();
+    meshes_.resize(header.meshCount);
+    bounds_.resize(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        CacheMeshEntry entry;
+        std::memcpy(&entry, base + sizeof(header) + i * sizeof(CacheMeshEntry), sizeof(entry));
+
+        // Nombres bornés par la taille du fichier avant toute multiplication, tableaux alignés
+        if (entry.vertexCount > file_.size() / (3 * sizeof(float)) || entry.indexCount > file_.size() / sizeof(unsigned int) ||
+            (entry.positionsOffset | entry.normalsOffset | entry.texcoordsOffset | entry.indicesOffset) % sizeof(float) != 0) {
+            if (err) *err = "cache corrompu : " + cachePath;
+            meshes_.clear();
+            bounds_.clear();
+            return false;
+        }
+        const uint64_t vertexBytes = entry.vertexCount * 3 * sizeof(float);
+        const uint64_t uvBytes = (entry.flags & kHasTexcoords) ? entry.vertexCount * 2 * sizeof(float) : 0;
+        const uint64_t normalBytes = (entry.flags & kHasNormals) ? vertexBytes : 0;
+        if (!inFile(entry.nameOffset, entry.nameLength, file_.size()) ||
+            !inFile(entry.positionsOffset, vertexBytes, file_.size()) ||
+            !inFile(entry.normalsOffset, normalBytes, file_.size()) ||
+            !inFile(entry.texcoordsOffset, uvBytes, file_.size()) ||
+            !inFile(entry.indicesOffset, entry.indexCount * sizeof(unsigned int), file_.size())) {
+            if (err) *err = "cache tronqué : " + cachePath;
+            meshes_.clear();
+            bounds_.clear();
+            return false;
+        }
+
+        MeshView& view = meshes_[i];
+        view.name = std::string_view(base + entry.nameOffset, entry.nameLength);
+        view.positions = reinterpret_cast<const float*>(base + entry.positionsOffset);
+        view.normals = (entry.flags & kHasNormals) ? reinterpret_cast<const float*>(base + entry.normalsOffset) : nullptr;
+        view.texcoords = (entry.flags & kHasTexcoords) ? reinterpret_cast<const float*>(base + entry.texcoordsOffset) : nullptr;
+        view.indices = reinterpret_cast<const unsigned int*>(base + entry.indicesOffset);
+        view.vertexCount = entry.vertexCount;
+        view.indexCount = entry.indexCount;
+
+        // Les vues partent telles quelles vers glDrawElements, le rendu logiciel et la sélection :
+        // un indice hors limites y deviendrait une lecture hors du tableau
+        for (size_t k = 0; k < view.indexCount; ++k) {
+            if (view.indices[k] >= view.vertexCount) {
+                if (err) *err = "cache corrompu (indices hors limites) : " + cachePath;
+                meshes_.clear();
+                bounds_.clear();
+                return false;
+            }
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            bounds_[i].min[k] = entry.boundsMin[k];
+            bounds_[i].max[k] = entry.boundsMax[k];
+        }
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "mesh_view.h"
+#include "obj_parser.h"
+
+// Cache binaire versionné des meshes chargés, écrit à côté du fichier source.
+// Il est associé à la taille, la date de modification et l'empreinte du contenu de la source, ainsi
+// qu'aux options du chargement qui l'a produit, et relu par projection en mémoire : les vues pointent
+// directement dans le fichier.
+const uint32_t kMeshCacheVersion = 2;
+
+// Chargeur ayant produit les meshes
+enum class MeshCacheLoader : uint32_t { Assimp, ParallelObj, MappedObj, Stl, Ply };
+
+// Options du chargement enregistrées dans l'en-tête : un cache écrit avec d'autres options
+// (chargeur, fusion des sommets, optimisation des indices) ne correspond pas au modèle demandé
+struct MeshCacheOptions {
+    MeshCacheLoader loader = MeshCacheLoader::Assimp;
+    bool weld = false;
+    float weldEpsilon = 0.0f;
+    bool optimizeIndices = false;
+};
+
+std::string meshCachePath(const std::string& sourcePath);
+
+// Taille et date de modification (nanosecondes) d'un fichier source
+bool statSource(const std::string& path, uint64_t& size, int64_t& mtime, std::string* err);
+
+// Empreinte 64 bits, mot par mot (8 octets), suffisante pour détecter une modification
+uint64_t hashBytes(const char* data, size_t size);
+
+// Empreinte 64 bits du contenu d'un fichier
+bool hashFileContents(const std::string& path, uint64_t& hash, std::string* err);
+
+bool writeMeshCache(const std::string& cachePath, const std::string& sourcePath, const ObjModel& model,
+                    const std::vector<MeshBounds>& bounds, const MeshCacheOptions& options, std::string* err);
+
+class MeshCache {
+public:
+    // Ouvre le cache et vérifie qu'il correspond toujours à la source et aux options
+    bool open(const std::string& cachePath, const std::string& sourcePath, const MeshCacheOptions& options, std::string* err);
+
+    size_t meshCount() const { return meshes_.size(); }
+    const MeshView& mesh(size_t i) const { return meshes_[i]; }
+    const MeshBounds& bounds(size_t i) const { return bounds_[i]; }
+    const std::vector<MeshView>& meshes() const { return meshes_; }
+
+private:
+    MappedFile file_;
+    std::vector<MeshView> meshes_;
+    std::vector<MeshBounds> bounds_;
+};
@@ -0,0 +1,281 @@
+#include "mesh_optimize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+const unsigned int kForsythCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+// Score de Forsyth d'un sommet selon sa position dans le cache LRU (-1 : absent)
+// et le nombre de triangles non émis qui l'utilisent encore
+float vertexScore(int cachePosition, unsigned int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = kLastTriangleScore; // sommets du dernier triangle émis
+        } else {
+            const float scale = 1.0f / (kForsythCacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, kCacheDecayPower);
+        }
+    }
+    return score + kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+}
+
+} // namespace
+
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize) {
+    VertexCacheStats stats;
+    if (indices.empty() || vertexCount == 0) {
+        return stats;
+    }
+    // Horodatage d'entrée dans la FIFO : un sommet y est encore si moins de cacheSize entrées ont suivi
+    std::vector<size_t> entered(vertexCount, 0);
+    size_t time = cacheSize + 1;
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (time - entered[index] > cacheSize) {
+            entered[index] = time++;
+            ++misses;
+        }
+    }
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount);
+    return stats;
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Triangles adjacents à chaque sommet (stockage compact par sommet)
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int index : indices) {
+        ++remaining[index];
+    }
+    std::vector<unsigned int> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        score[v] = vertexScore(-1, remaining[v]);
+    }
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> nextCache;
+    cache.reserve(kForsythCacheSize + 3);
+    nextCache.reserve(kForsythCacheSize + 3);
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    size_t scanCursor = 0;
+    size_t best = 0;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (s > bestScore) {
+            bestScore = s;
+            best = t;
+        }
+    }
+
+    while (true) {
+        emitted[best] = true;
+        const unsigned int* triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+
+        // Le triangle émis sort des listes d'adjacence de ses sommets
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int v = triangle[k];
+            unsigned int* begin = &adjacency[adjacencyStart[v]];
+            unsigned int* end = begin + remaining[v];
+            std::iter_swap(std::find(begin, end, static_cast<unsigned int>(best)), end - 1);
+            --remaining[v];
+        }
+
+        // Les sommets du triangle passent en tête du cache LRU
+        nextCache.assign(triangle, triangle + 3);
+        for (unsigned int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                nextCache.push_back(v);
+            }
+        }
+        for (size_t i = kForsythCacheSize; i < nextCache.size(); ++i) {
+            cachePosition[nextCache[i]] = -1;
+            score[nextCache[i]] = vertexScore(-1, remaining[nextCache[i]]);
+        }
+        if (nextCache.size() > kForsythCacheSize) {
+            nextCache.resize(kForsythCacheSize);
+        }
+        cache.swap(nextCache);
+
+        // Mise à jour des scores des sommets en cache et recherche du meilleur triangle voisin
+        for (size_t i = 0; i < cache.size(); ++i) {
+            cachePosition[cache[i]] = static_cast<int>(i);
+            score[cache[i]] = vertexScore(static_cast<int>(i), remaining[cache[i]]);
+        }
+        bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int a = adjacencyStart[v]; a < adjacencyStart[v] + remaining[v]; ++a) {
+                const unsigned int t = adjacency[a];
+                const float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+
+        if (bestScore < 0.0f) {
+            // Aucun triangle ne touche le cache : on repart du premier triangle non émis
+            while (scanCursor < triangleCount && emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            if (scanCursor == triangleCount) {
+                break;
+            }
+            best = scanCursor;
+        }
+    }
+    indices.swap(output);
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t vertexCount,
+                      const MeshBounds& bounds, unsigned int cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Un groupe commence à chaque triangle dont les trois sommets manquent dans le cache :
+    // réordonner les groupes entiers ne dégrade presque pas l'ACMR obtenu
+    std::vector<size_t> clusterStarts;
+    std::vector<size_t> entered(vertexCount, 0);
+    size_t time = cacheSize + 1;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int index = indices[t * 3 + k];
+            if (time - entered[index] > cacheSize) {
+                entered[index] = time++;
+                ++misses;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusterStarts.push_back(t);
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    const size_t clusterCount = clusterStarts.size() - 1;
+
+    const float center[3] = {(bounds.min[0] + bounds.max[0]) * 0.5f, (bounds.min[1] + bounds.max[1]) * 0.5f,
+                             (bounds.min[2] + bounds.max[2]) * 0.5f};
+
+    // Clé de tri : projection du centre du groupe, vu depuis le centre du mesh, sur sa normale moyenne
+    // (pondérée par l'aire). Les groupes tournés vers l'extérieur et éloignés passent en premier.
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float normal[3] = {0.0f, 0.0f, 0.0f};
+        float centroid[3] = {0.0f, 0.0f, 0.0f};
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const float* a = positions + size_t(indices[t * 3]) * 3;
+            const float* b = positions + size_t(indices[t * 3 + 1]) * 3;
+            const float* d = positions + size_t(indices[t * 3 + 2]) * 3;
+            const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const float e2[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+            const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                                e1[0] * e2[1] - e1[1] * e2[0]};
+            const float twiceArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k) {
+                normal[k] += n[k];
+                centroid[k] += (a[k] + b[k] + d[k]) / 3.0f * twiceArea;
+            }
+            area += twiceArea;
+        }
+        if (area > 0.0f) {
+            for (int k = 0; k < 3; ++k) {
+                centroid[k] = centroid[k] / area - center[k];
+            }
+        }
+        sortKey[c] = centroid[0] * normal[0] + centroid[1] * normal[1] + centroid[2] * normal[2];
+        if (area > 0.0f) {
+            sortKey[c] /= area;
+        }
+    }
+
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (size_t c : order) {
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+void optimizeVertexFetch(ObjMesh& mesh) {
+    const size_t vertexCount = mesh.vertexCount();
+    const unsigned int kUnused = ~0u;
+    std::vector<unsigned int> remap(vertexCount, kUnused);
+    std::vector<unsigned int> order;
+    order.reserve(vertexCount);
+    for (unsigned int& index : mesh.indices) {
+        if (remap[index] == kUnused) {
+            remap[index] = static_cast<unsigned int>(order.size());
+            order.push_back(index);
+        }
+        index = remap[index];
+    }
+
+    // Les sommets jamais référencés disparaissent
+    auto gather = [&](std::vector<float>& values, size_t components) {
+        if (values.empty()) {
+            return;
+        }
+        std::vector<float> reordered(order.size() * components);
+        for (size_t i = 0; i < order.size(); ++i) {
+            std::copy_n(&values[size_t(order[i]) * components], components, &reordered[i * components]);
+        }
+        values.swap(reordered);
+    };
+    gather(mesh.positions, 3);
+    gather(mesh.normals, 3);
+    gather(mesh.texcoords, 2);
+}
+
+void optimizeMesh(ObjMesh& mesh, MeshOptimizeStats* stats) {
+    if (stats) {
+        stats->before = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+    }
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    optimizeOverdraw(mesh.indices, mesh.positions.data(), mesh.vertexCount(), computeBounds(mesh.view()));
+    optimizeVertexFetch(mesh);
+    if (stats) {
+        stats->after = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mesh_view.h"
+#include "obj_parser.h"
+
+// Statistiques d'un cache de sommets post-transformation FIFO simulé :
+// ACMR = sommets transformés par triangle (0.5 idéal sur une grille, 3 au pire),
+// ATVR = sommets transformés par sommet du mesh (1 idéal)
+struct VertexCacheStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+const unsigned int kVertexCacheSize = 16;
+
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize = kVertexCacheSize);
+
+// Réordonne les triangles pour maximiser les succès du cache de sommets (algorithme de Forsyth,
+// cache LRU de 32 entrées)
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+// Découpe l'ordre issu de optimizeVertexCache en groupes de triangles contigus (coupés là où le
+// cache repart à froid) et trie ces groupes de l'extérieur vers le centre de la boîte englobante,
+// pour que les faces extérieures soient dessinées en premier
+void optimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t vertexCount,
+                      const MeshBounds& bounds, unsigned int cacheSize = kVertexCacheSize);
+
+// Renumérote les sommets dans l'ordre de leur première utilisation par les indices
+void optimizeVertexFetch(ObjMesh& mesh);
+
+struct MeshOptimizeStats {
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// Enchaîne les trois étapes sur un mesh
+void optimizeMesh(ObjMesh& mesh, MeshOptimizeStats* stats = nullptr);
@@ -0,0 +1,395 @@
+#include "mesh_pack.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "lz_codec.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "path_utils.h"
+
+namespace {
+
+const char kMagic[8] = {'M', 'E', 'S', 'H', 'P', 'A', 'C', 'K'};
+const uint32_t kByteOrderMark = 0x01020304;
+const uint64_t kAlignment = 16;
+const size_t kBlockValues = 65536; // valeurs de 32 bits par bloc (256 Ko non compressés)
+
+const uint32_t kHasNormals = 1;
+const uint32_t kHasTexcoords = 2;
+
+enum Stream : uint16_t { Positions = 0, Normals = 1, Texcoords = 2, Indices = 3, StreamCount = 4 };
+
+enum Method : uint16_t { Stored = 0, Lz = 1 };
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t meshCount;
+    uint32_t blockCount;
+    uint64_t reserved;
+};
+
+struct PackMeshEntry {
+    uint64_t nameOffset;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint32_t nameLength;
+    uint32_t flags;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+struct PackBlockEntry {
+    uint32_t mesh;
+    uint16_t stream;
+    uint16_t method;
+    uint64_t firstValue; // position du bloc dans le tableau de l'attribut, en valeurs de 32 bits
+    uint64_t valueCount;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+static_assert(sizeof(PackHeader) == 32, "format du conteneur modifié");
+static_assert(sizeof(PackMeshEntry) == 56, "format du conteneur modifié");
+static_assert(sizeof(PackBlockEntry) == 40, "format du conteneur modifié");
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+bool inFile(uint64_t offset, uint64_t bytes, size_t fileSize) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+// Nombre de composantes entrelacées par sommet : le delta se fait entre composantes de même rang
+size_t streamComponents(uint16_t stream) {
+    switch (stream) {
+        case Positions:
+        case Normals: return 3;
+        case Texcoords: return 2;
+        default: return 1;
+    }
+}
+
+size_t streamValues(const PackMeshEntry& entry, uint16_t stream) {
+    switch (stream) {
+        case Positions: return entry.vertexCount * 3;
+        case Normals: return (entry.flags & kHasNormals) ? entry.vertexCount * 3 : 0;
+        case Texcoords: return (entry.flags & kHasTexcoords) ? entry.vertexCount * 2 : 0;
+        default: return entry.indexCount;
+    }
+}
+
+const uint32_t* streamData(const MeshView& mesh, uint16_t stream) {
+    switch (stream) {
+        case Positions: return reinterpret_cast<const uint32_t*>(mesh.positions);
+        case Normals: return reinterpret_cast<const uint32_t*>(mesh.normals);
+        case Texcoords: return reinterpret_cast<const uint32_t*>(mesh.texcoords);
+        default: return mesh.indices;
+    }
+}
+
+uint32_t* streamData(ObjMesh& mesh, uint16_t stream) {
+    switch (stream) {
+        case Positions: return reinterpret_cast<uint32_t*>(mesh.positions.data());
+        case Normals: return reinterpret_cast<uint32_t*>(mesh.normals.data());
+        case Texcoords: return reinterpret_cast<uint32_t*>(mesh.texcoords.data());
+        default: return mesh.indices.data();
+    }
+}
+
+// Filtre avant compression : les flottants deviennent la différence (sur leur représentation binaire)
+// avec la même composante du sommet précédent, les indices la différence signée avec l'indice précédent
+// (zigzag), puis les octets de même rang sont regroupés pour que les poids forts, presque constants,
+// forment de longues répétitions. Le delta repart de zéro à chaque bloc.
+void filterBlock(const uint32_t* values, size_t count, size_t components, bool zigzag, uint8_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t previous = i >= components ? values[i - components] : 0;
+        uint32_t delta = values[i] - previous;
+        if (zigzag) {
+            int32_t signedDelta = static_cast<int32_t>(delta);
+            delta = (static_cast<uint32_t>(signedDelta) << 1) ^ static_cast<uint32_t>(signedDelta >> 31);
+        }
+        out[i] = static_cast<uint8_t>(delta);
+        out[count + i] = static_cast<uint8_t>(delta >> 8);
+        out[2 * count + i] = static_cast<uint8_t>(delta >> 16);
+        out[3 * count + i] = static_cast<uint8_t>(delta >> 24);
+    }
+}
+
+void unfilterBlock(const uint8_t* in, size_t count, size_t components, bool zigzag, uint32_t* values) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t delta = uint32_t(in[i]) | (uint32_t(in[count + i]) << 8) | (uint32_t(in[2 * count + i]) << 16) |
+                         (uint32_t(in[3 * count + i]) << 24);
+        if (zigzag) {
+            delta = (delta >> 1) ^ (0u - (delta & 1));
+        }
+        uint32_t previous = i >= components ? values[i - components] : 0;
+        values[i] = previous + delta;
+    }
+}
+
+} // namespace
+
+std::string meshPackPath(const std::string& sourcePath) {
+    return sourcePath + ".meshpack";
+}
+
+bool isMeshPackPath(const std::string& path) {
+    return hasExtension(path, ".meshpack");
+}
+
+bool writeMeshPack(const std::string& packPath, const std::vector<MeshView>& meshes,
+                   const std::vector<MeshBounds>& bounds, std::string* err, MeshPackStats* stats,
+                   unsigned int numThreads) {
+    PackHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kMeshPackVersion;
+    header.byteOrder = kByteOrderMark;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+
+    // Table des meshes et découpage de chaque attribut en blocs (multiples du nombre de composantes)
+    std::vector<PackMeshEntry> entries(meshes.size());
+    std::vector<PackBlockEntry> blocks;
+    uint64_t rawBytes = 0;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const MeshView& mesh = meshes[i];
+        PackMeshEntry& entry = entries[i];
+        entry.vertexCount = mesh.vertexCount;
+        entry.indexCount = mesh.indexCount;
+        entry.nameLength = static_cast<uint32_t>(mesh.name.size());
+        entry.flags = (mesh.normals ? kHasNormals : 0) | (mesh.texcoords ? kHasTexcoords : 0);
+        for (int k = 0; k < 3; ++k) {
+            entry.boundsMin[k] = bounds[i].min[k];
+            entry.boundsMax[k] = bounds[i].max[k];
+        }
+        for (uint16_t stream = 0; stream < StreamCount; ++stream) {
+            const size_t values = streamValues(entry, stream);
+            const size_t blockValues = kBlockValues - kBlockValues % streamComponents(stream);
+            for (size_t first = 0; first < values; first += blockValues) {
+                PackBlockEntry block = {};
+                block.mesh = static_cast<uint32_t>(i);
+                block.stream = stream;
+                block.firstValue = first;
+                block.valueCount = std::min(blockValues, values - first);
+                blocks.push_back(block);
+            }
+            rawBytes += values * sizeof(uint32_t);
+        }
+    }
+    header.blockCount = static_cast<uint32_t>(blocks.size());
+
+    // Compression des blocs en parallèle ; un bloc qui ne gagne rien est stocké tel quel
+    std::vector<std::vector<uint8_t>> packed(blocks.size());
+    parallelFor(blocks.size(), [&](size_t b) {
+        PackBlockEntry& block = blocks[b];
+        const uint32_t* values = streamData(meshes[block.mesh], block.stream) + block.firstValue;
+        std::vector<uint8_t> filtered(block.valueCount * sizeof(uint32_t));
+        filterBlock(values, block.valueCount, streamComponents(block.stream), block.stream == Indices, filtered.data());
+        lzCompress(filtered.data(), filtered.size(), packed[b]);
+        block.method = Lz;
+        if (packed[b].size() >= filtered.size()) {
+            packed[b].swap(filtered);
+            block.method = Stored;
+        }
+        block.dataSize = packed[b].size();
+    }, numThreads);
+
+    // Disposition : en-tête, tables des meshes et des blocs, noms, puis blocs alignés sur 16 octets
+    uint64_t offset = sizeof(PackHeader) + entries.size() * sizeof(PackMeshEntry) + blocks.size() * sizeof(PackBlockEntry);
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        entries[i].nameOffset = offset;
+        offset += meshes[i].name.size();
+    }
+    for (PackBlockEntry& block : blocks) {
+        offset = alignUp(offset);
+        block.dataOffset = offset;
+        offset += block.dataSize;
+    }
+
+    // Écriture dans un fichier temporaire renommé à la fin, pour ne jamais laisser un conteneur partiel
+    const std::string tempPath = packPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (err) *err = "impossible d'écrire " + tempPath;
+            return false;
+        }
+        uint64_t written = 0;
+        auto writeAt = [&](uint64_t position, const void* data, size_t bytes) {
+            static const char zeros[kAlignment] = {};
+            while (written < position) {
+                size_t pad = static_cast<size_t>(std::min<uint64_t>(position - written, kAlignment));
+                out.write(zeros, static_cast<std::streamsize>(pad));
+                written += pad;
+            }
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+
+        writeAt(0, &header, sizeof(header));
+        writeAt(sizeof(header), entries.data(), entries.size() * sizeof(PackMeshEntry));
+        writeAt(written, blocks.data(), blocks.size() * sizeof(PackBlockEntry));
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            writeAt(entries[i].nameOffset, meshes[i].name.data(), meshes[i].name.size());
+        }
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            writeAt(blocks[b].dataOffset, packed[b].data(), packed[b].size());
+        }
+        if (!out) {
+            if (err) *err = "erreur d'écriture de " + tempPath;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), packPath.c_str()) != 0) {
+        if (err) *err = "impossible de renommer " + tempPath;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    if (stats) {
+        stats->rawBytes = rawBytes;
+        stats->packedBytes = offset;
+        stats->blockCount = blocks.size();
+    }
+    return true;
+}
+
+bool readMeshPack(const std::string& packPath, ObjModel& model, std::vector<MeshBounds>& bounds, std::string* err,
+                  unsigned int numThreads) {
+    model.meshes.clear();
+    bounds.clear();
+    MappedFile file;
+    if (!file.open(packPath, err)) {
+        return false;
+    }
+
+    PackHeader header;
+    if (file.size() < sizeof(header)) {
+        if (err) *err = "conteneur tronqué : " + packPath;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.byteOrder != kByteOrderMark) {
+        if (err) *err = "conteneur de meshes invalide : " + packPath;
+        return false;
+    }
+    if (header.version != kMeshPackVersion) {
+        if (err) *err = "version de conteneur non prise en charge : " + packPath;
+        return false;
+    }
+
+    const uint64_t meshTableBytes = uint64_t(header.meshCount) * sizeof(PackMeshEntry);
+    const uint64_t blockTableBytes = uint64_t(header.blockCount) * sizeof(PackBlockEntry);
+    if (!inFile(sizeof(header), meshTableBytes, file.size()) ||
+        !inFile(sizeof(header) + meshTableBytes, blockTableBytes, file.size())) {
+        if (err) *err = "conteneur tronqué : " + packPath;
+        return false;
+    }
+    const char* base = file.data();
+    std::vector<PackMeshEntry> entries(header.meshCount);
+    std::vector<PackBlockEntry> blocks(header.blockCount);
+    std::memcpy(entries.data(), base + sizeof(header), meshTableBytes);
+    std::memcpy(blocks.data(), base + sizeof(header) + meshTableBytes, blockTableBytes);
+
+    // Allocation des tableaux de chaque mesh : les blocs y sont ensuite décodés en place
+    model.meshes.resize(entries.size());
+    bounds.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const PackMeshEntry& entry = entries[i];
+        // Un octet compressé se décode en au plus 255 octets : borne les allocations d'un fichier corrompu
+        const uint64_t maxValues = uint64_t(file.size()) * 64;
+        if (!inFile(entry.nameOffset, entry.nameLength, file.size()) || entry.vertexCount > maxValues ||
+            entry.indexCount > maxValues) {
+            if (err) *err = "conteneur tronqué : " + packPath;
+            model.meshes.clear();
+            bounds.clear();
+            return false;
+        }
+        ObjMesh& mesh = model.meshes[i];
+        mesh.name.assign(base + entry.nameOffset, entry.nameLength);
+        mesh.positions.resize(streamValues(entry, Positions));
+        mesh.normals.resize(streamValues(entry, Normals));
+        mesh.texcoords.resize(streamValues(entry, Texcoords));
+        mesh.indices.resize(streamValues(entry, Indices));
+        for (int k = 0; k < 3; ++k) {
+            bounds[i].min[k] = entry.boundsMin[k];
+            bounds[i].max[k] = entry.boundsMax[k];
+        }
+    }
+
+    // Les blocs de chaque attribut doivent se suivre dans l'ordre et le couvrir exactement : chaque bloc
+    // commence où finit le précédent, ce qui garantit qu'aucun tableau n'est écrit par deux threads
+    std::vector<uint64_t> covered(entries.size() * StreamCount, 0);
+    for (const PackBlockEntry& block : blocks) {
+        if (block.mesh >= entries.size() || block.stream >= StreamCount ||
+            block.valueCount > streamValues(entries[block.mesh], block.stream) ||
+            block.firstValue > streamValues(entries[block.mesh], block.stream) - block.valueCount ||
+            !inFile(block.dataOffset, block.dataSize, file.size())) {
+            if (err) *err = "conteneur tronqué : " + packPath;
+            model.meshes.clear();
+            bounds.clear();
+            return false;
+        }
+        uint64_t& next = covered[block.mesh * StreamCount + block.stream];
+        if (block.firstValue != next) {
+            if (err) *err = "blocs désordonnés ou superposés : " + packPath;
+            model.meshes.clear();
+            bounds.clear();
+            return false;
+        }
+        next += block.valueCount;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        for (uint16_t stream = 0; stream < StreamCount; ++stream) {
+            if (covered[i * StreamCount + stream] != streamValues(entries[i], stream)) {
+                if (err) *err = "conteneur incomplet : " + packPath;
+                model.meshes.clear();
+                bounds.clear();
+                return false;
+            }
+        }
+    }
+
+    std::atomic<bool> corrupted(false);
+    parallelFor(blocks.size(), [&](size_t b) {
+        const PackBlockEntry& block = blocks[b];
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(base + block.dataOffset);
+        const size_t rawSize = block.valueCount * sizeof(uint32_t);
+        std::vector<uint8_t> filtered;
+        if (block.method == Lz) {
+            filtered.resize(rawSize);
+            if (!lzDecompress(data, block.dataSize, filtered.data(), rawSize)) {
+                corrupted = true;
+                return;
+            }
+            data = filtered.data();
+        } else if (block.method != Stored || block.dataSize != rawSize) {
+            corrupted = true;
+            return;
+        }
+        uint32_t* values = streamData(model.meshes[block.mesh], block.stream) + block.firstValue;
+        unfilterBlock(data, block.valueCount, streamComponents(block.stream), block.stream == Indices, values);
+        if (block.stream == Indices) {
+            const uint64_t vertexCount = entries[block.mesh].vertexCount;
+            for (uint64_t v = 0; v < block.valueCount; ++v) {
+                if (values[v] >= vertexCount) {
+                    corrupted = true;
+                    return;
+                }
+            }
+        }
+    }, numThreads);
+
+    if (corrupted) {
+        if (err) *err = "bloc corrompu (données compressées ou indices hors limites) : " + packPath;
+        model.meshes.clear();
+        bounds.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh_view.h"
+#include "obj_parser.h"
+
+// Conteneur compressé autonome des meshes (<modèle>.meshpack), sans dépendance externe.
+// Chaque attribut (positions, normales, uv, indices) est découpé en blocs d'environ 256 Ko
+// décodables indépendamment : valeurs filtrées (delta par composante puis octets regroupés
+// par rang) et compressées par lz_codec, ce qui permet de les décompresser sur tous les coeurs.
+const uint32_t kMeshPackVersion = 1;
+
+std::string meshPackPath(const std::string& sourcePath);
+
+// Vrai si le chemin désigne un conteneur .meshpack
+bool isMeshPackPath(const std::string& path);
+
+struct MeshPackStats {
+    uint64_t rawBytes = 0;    // attributs non compressés
+    uint64_t packedBytes = 0; // taille du fichier écrit
+    size_t blockCount = 0;
+};
+
+bool writeMeshPack(const std::string& packPath, const std::vector<MeshView>& meshes,
+                   const std::vector<MeshBounds>& bounds, std::string* err, MeshPackStats* stats = nullptr,
+                   unsigned int numThreads = 0);
+
+// Relit le conteneur et décompresse ses blocs en parallèle (numThreads = 0 utilise tous les coeurs)
+bool readMeshPack(const std::string& packPath, ObjModel& model, std::vector<MeshBounds>& bounds, std::string* err,
+                  unsigned int numThreads = 0);
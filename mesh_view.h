@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <string_view>
+
+// Vue non propriétaire sur un mesh indexé triangulé (positions/normales xyz, uv, 3 indices par triangle).
+// Les pointeurs peuvent désigner un ObjMesh comme une zone projetée en mémoire.
+struct MeshView {
+    std::string_view name;
+    const float* positions = nullptr;
+    const float* normals = nullptr;   // nullptr si absent
+    const float* texcoords = nullptr; // nullptr si absent
+    const unsigned int* indices = nullptr;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+};
+
+// Boîte englobante alignée sur les axes, indépendante d'Assimp
+struct MeshBounds {
+    float min[3];
+    float max[3];
+};
+
+inline MeshBounds computeBounds(const MeshView& mesh) {
+    MeshBounds bounds = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+    for (size_t i = 0; i < mesh.vertexCount; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            float value = mesh.positions[i * 3 + k];
+            bounds.min[k] = value < bounds.min[k] ? value : bounds.min[k];
+            bounds.max[k] = value > bounds.max[k] ? value : bounds.max[k];
+        }
+    }
+    return bounds;
+}
@@ -0,0 +1,245 @@
+// Conversion par lots d'un dossier de modèles OBJ, sans fenêtre : chaque fichier passe par le même
+// chargement que le visualiseur (Assimp ou chargeurs natifs, fusion des sommets, optimisation des
+// indices, boîtes englobantes) puis est écrit en .meshpack (ou en .meshcache à côté de la source).
+// Les fichiers sont traités en parallèle, un par thread ; un rapport est affiché pour chacun.
+//
+//   g++ -std=c++17 -O2 -Idependencies/include obj_convert.cpp lz_codec.cpp mapped_file.cpp mesh_cache.cpp
+//       mesh_optimize.cpp mesh_pack.cpp obj_index.cpp obj_parser.cpp float_parser.cpp scene_builder.cpp weld.cpp
+//       tiny_obj_loader.cc -lassimp -lpthread -o ObjConvert
+//   ./ObjConvert <dossier> [-o sortie] [--format=meshpack|meshcache] [--mmap-obj|--parallel-obj]
+//                [--weld[=epsilon]] [--optimize-indices] [--threads=N]
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mesh_cache.h"
+#include "mesh_optimize.h"
+#include "mesh_pack.h"
+#include "obj_parser.h"
+#include "parallel.h"
+#include "path_utils.h"
+#include "scene_builder.h"
+#include "weld.h"
+
+namespace {
+
+enum class ModelLoader { Assimp, ParallelObj, MappedObj };
+
+struct ConvertOptions {
+    std::string inputDir;
+    std::string outputDir; // vide : à côté des sources
+    bool writeCache = false;
+    ModelLoader loader = ModelLoader::Assimp;
+    bool weld = false;
+    float weldEpsilon = 0.0f;
+    bool optimizeIndices = false;
+    unsigned int numThreads = 0;
+};
+
+struct ConvertResult {
+    std::string outputPath;
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+    uint64_t vertices = 0;
+    uint64_t triangles = 0;
+    double milliseconds = 0.0;
+    std::string error;
+};
+
+// Fichiers .obj du dossier (non récursif), triés par nom
+bool listObjFiles(const std::string& dir, std::vector<std::string>& names, std::string* err) {
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) {
+        if (err) *err = "dossier introuvable : " + dir;
+        return false;
+    }
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        struct stat info;
+        if (hasExtension(name, ".obj") && stat((dir + "/" + name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            names.push_back(name);
+        }
+    }
+    closedir(handle);
+    std::sort(names.begin(), names.end());
+    return true;
+}
+
+// Même chargement que loadModel() : triangulation, UV inversées et sommets identiques joints
+// (sauf si la fusion du module weld les remplace), puis fusion et optimisation des indices
+bool importModel(const std::string& path, const ConvertOptions& options, ObjModel& model, std::string* err) {
+    if (options.loader == ModelLoader::Assimp) {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs |
+                                                       (options.weld ? 0 : aiProcess_JoinIdenticalVertices));
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            if (err) *err = std::string("import Assimp impossible : ") + importer.GetErrorString();
+            return false;
+        }
+        model = extractModel(scene);
+    } else {
+        // Un fichier par thread : chaque étape reste sur un seul coeur
+        bool loaded = (options.loader == ModelLoader::MappedObj) ? loadObjMapped(path, model, err, 1)
+                                                                 : loadObjParallel(path, model, err, 1);
+        if (!loaded) {
+            return false;
+        }
+    }
+
+    if (options.weld) {
+        WeldOptions weldOptions;
+        weldOptions.epsilon = options.weldEpsilon;
+        weldOptions.numThreads = 1;
+        weldModel(model, weldOptions, nullptr);
+    }
+    if (options.optimizeIndices) {
+        for (ObjMesh& mesh : model.meshes) {
+            optimizeMesh(mesh, nullptr);
+        }
+    }
+    return true;
+}
+
+// Options enregistrées dans le cache, identiques à celles du visualiseur pour le même chargement
+MeshCacheOptions cacheOptions(const ConvertOptions& options) {
+    MeshCacheOptions cache;
+    cache.loader = options.loader == ModelLoader::ParallelObj ? MeshCacheLoader::ParallelObj
+                 : options.loader == ModelLoader::MappedObj   ? MeshCacheLoader::MappedObj
+                                                              : MeshCacheLoader::Assimp;
+    cache.weld = options.weld;
+    cache.weldEpsilon = options.weldEpsilon;
+    cache.optimizeIndices = options.optimizeIndices;
+    return cache;
+}
+
+ConvertResult convertFile(const std::string& name, const ConvertOptions& options) {
+    ConvertResult result;
+    auto start = std::chrono::steady_clock::now();
+    const std::string path = options.inputDir + "/" + name;
+
+    int64_t mtime = 0;
+    ObjModel model;
+    if (statSource(path, result.inputBytes, mtime, &result.error) && importModel(path, options, model, &result.error)) {
+        std::vector<MeshBounds> bounds;
+        for (const ObjMesh& mesh : model.meshes) {
+            bounds.push_back(computeBounds(mesh.view()));
+            result.vertices += mesh.vertexCount();
+            result.triangles += mesh.triangleCount();
+        }
+
+        bool written;
+        if (options.writeCache) {
+            // Le cache est associé à sa source : il reste à côté pour que --mesh-cache le retrouve
+            result.outputPath = meshCachePath(path);
+            written = writeMeshCache(result.outputPath, path, model, bounds, cacheOptions(options), &result.error);
+        } else {
+            result.outputPath = meshPackPath((options.outputDir.empty() ? options.inputDir : options.outputDir) + "/" + name);
+            written = writeMeshPack(result.outputPath, model.views(), bounds, &result.error, nullptr, 1);
+        }
+        if (written) {
+            statSource(result.outputPath, result.outputBytes, mtime, &result.error);
+        }
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void printUsage() {
+    std::cerr << "usage : ObjConvert <dossier> [-o sortie] [--format=meshpack|meshcache] [--mmap-obj|--parallel-obj]\n"
+                 "                  [--weld[=epsilon]] [--optimize-indices] [--threads=N]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ConvertOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--format=meshpack") {
+            options.writeCache = false;
+        } else if (arg == "--format=meshcache") {
+            options.writeCache = true;
+        } else if (arg == "--parallel-obj") {
+            options.loader = ModelLoader::ParallelObj;
+        } else if (arg == "--mmap-obj") {
+            options.loader = ModelLoader::MappedObj;
+        } else if (arg == "--weld") {
+            options.weld = true;
+        } else if (arg.rfind("--weld=", 0) == 0) {
+            options.weld = true;
+            options.weldEpsilon = std::strtof(arg.c_str() + 7, nullptr);
+        } else if (arg == "--optimize-indices") {
+            options.optimizeIndices = true;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            options.numThreads = static_cast<unsigned int>(std::strtoul(arg.c_str() + 10, nullptr, 10));
+        } else if (arg.rfind("-", 0) != 0 && options.inputDir.empty()) {
+            options.inputDir = arg;
+        } else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.inputDir.empty()) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (options.writeCache && !options.outputDir.empty()) {
+        std::cerr << "-o ignoré : les fichiers .meshcache sont écrits à côté de leur source" << std::endl;
+    }
+
+    std::vector<std::string> names;
+    std::string error;
+    if (!listObjFiles(options.inputDir, names, &error)) {
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!options.outputDir.empty() && !options.writeCache) {
+        mkdir(options.outputDir.c_str(), 0755);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ConvertResult> results(names.size());
+    std::mutex printMutex;
+    std::atomic<size_t> done(0);
+    parallelFor(names.size(), [&](size_t i) {
+        results[i] = convertFile(names[i], options);
+        const ConvertResult& result = results[i];
+        std::lock_guard<std::mutex> lock(printMutex);
+        std::cout << "[" << ++done << "/" << names.size() << "] " << names[i];
+        if (!result.error.empty()) {
+            std::cout << " : ÉCHEC (" << result.error << ")" << std::endl;
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(1) << " : " << result.milliseconds << " ms, "
+                  << result.inputBytes / 1024 << " -> " << result.outputBytes / 1024 << " Ko, " << result.vertices
+                  << " sommets, " << result.triangles << " triangles -> " << result.outputPath << std::endl;
+    }, options.numThreads);
+
+    size_t failed = 0;
+    uint64_t inputBytes = 0, outputBytes = 0;
+    for (const ConvertResult& result : results) {
+        failed += result.error.empty() ? 0 : 1;
+        inputBytes += result.inputBytes;
+        outputBytes += result.outputBytes;
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << std::fixed << std::setprecision(1) << names.size() - failed << " fichiers convertis, " << failed
+              << " échecs, " << inputBytes / 1024 << " -> " << outputBytes / 1024 << " Ko en " << elapsed.count()
+              << " ms (" << workerCount(options.numThreads) << " threads)" << std::endl;
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
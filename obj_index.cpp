@@ -0,0 +1,316 @@
+#include "obj_index.h"
+#include "mapped_file.h"
+#include "mesh_cache.h"
+#include "obj_tokenizer.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace {
+
+const char kMagic[8] = {'O', 'B', 'J', 'I', 'N', 'D', 'E', 'X'};
+
+// Résultat de la pré-analyse d'un bloc de lignes ; les bases des objets sont locales au bloc
+struct ScanResult {
+    std::vector<ObjObjectEntry> objects;
+    uint64_t v = 0;
+    uint64_t vt = 0;
+    uint64_t vn = 0;
+    uint64_t faces = 0;
+};
+
+void scanChunk(const char* data, size_t begin, size_t end, ScanResult& result) {
+    ObjCursor cursor(data + begin, data + end);
+    while (!cursor.atEnd()) {
+        cursor.skipSpaces();
+        const char* line = cursor.p;
+        if (cursor.end - line >= 2) {
+            if (line[0] == 'v') {
+                if (line[1] == ' ' || line[1] == '\t') {
+                    ++result.v;
+                } else if (line[1] == 't') {
+                    ++result.vt;
+                } else if (line[1] == 'n') {
+                    ++result.vn;
+                }
+            } else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+                ++result.faces;
+            } else if (cursor.keyword("o")) {
+                ObjObjectEntry entry;
+                entry.name = std::string(cursor.restOfLine());
+                entry.offset = static_cast<uint64_t>(line - data);
+                entry.vBase = result.v;
+                entry.vtBase = result.vt;
+                entry.vnBase = result.vn;
+                entry.faceCount = result.faces;
+                result.objects.push_back(entry);
+            }
+        }
+        cursor.nextLine();
+    }
+}
+
+size_t findBlock(const std::vector<ObjObjectEntry>& objects, uint64_t index, uint64_t ObjObjectEntry::*base) {
+    auto it = std::upper_bound(objects.begin(), objects.end(), index,
+                               [base](uint64_t value, const ObjObjectEntry& entry) { return value < entry.*base; });
+    return it == objects.begin() ? 0 : static_cast<size_t>(std::distance(objects.begin(), it) - 1);
+}
+
+void writeU64(std::ofstream& out, uint64_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool readU64(const char*& p, const char* end, uint64_t& value) {
+    if (end - p < static_cast<ptrdiff_t>(sizeof(value))) {
+        return false;
+    }
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return true;
+}
+
+} // namespace
+
+size_t ObjIndex::objectOfV(uint64_t index) const {
+    return findBlock(objects, index, &ObjObjectEntry::vBase);
+}
+
+size_t ObjIndex::objectOfVt(uint64_t index) const {
+    return findBlock(objects, index, &ObjObjectEntry::vtBase);
+}
+
+size_t ObjIndex::objectOfVn(uint64_t index) const {
+    return findBlock(objects, index, &ObjObjectEntry::vnBase);
+}
+
+std::string objIndexPath(const std::string& sourcePath) {
+    return sourcePath + ".objindex";
+}
+
+void buildObjIndex(const char* data, size_t size, ObjIndex& index, unsigned int numThreads) {
+    const std::vector<size_t> bounds = splitAtLines(data, size, numThreads);
+    std::vector<ScanResult> results(bounds.size() - 1);
+    parallelFor(results.size(), [&](size_t c) {
+        scanChunk(data, bounds[c], bounds[c + 1], results[c]);
+    }, numThreads);
+
+    // Bases globales par somme préfixe des compteurs de chaque bloc
+    index = ObjIndex();
+    uint64_t v = 0, vt = 0, vn = 0, faces = 0;
+    for (const ScanResult& result : results) {
+        for (ObjObjectEntry entry : result.objects) {
+            entry.vBase += v;
+            entry.vtBase += vt;
+            entry.vnBase += vn;
+            entry.faceCount += faces;
+            index.objects.push_back(entry);
+        }
+        v += result.v;
+        vt += result.vt;
+        vn += result.vn;
+        faces += result.faces;
+    }
+    index.totalV = v;
+    index.totalVt = vt;
+    index.totalVn = vn;
+
+    // Contenu avant le premier `o` : objet implicite couvrant le début du fichier, comme dans
+    // collectObjects, pour que chaque attribut appartienne à un bloc de l'index
+    const bool leadingContent = index.objects.empty()
+        ? (v > 0 || vt > 0 || vn > 0 || faces > 0)
+        : (index.objects[0].vBase > 0 || index.objects[0].vtBase > 0 || index.objects[0].vnBase > 0 ||
+           index.objects[0].faceCount > 0);
+    if (leadingContent) {
+        ObjObjectEntry entry;
+        entry.name = "defaultobject";
+        index.objects.insert(index.objects.begin(), entry);
+    }
+
+    // Longueurs et compteurs par différence avec l'objet suivant (faceCount contient encore la base)
+    for (size_t i = 0; i < index.objects.size(); ++i) {
+        ObjObjectEntry& entry = index.objects[i];
+        const bool last = (i + 1 == index.objects.size());
+        const ObjObjectEntry* next = last ? nullptr : &index.objects[i + 1];
+        entry.length = (last ? size : next->offset) - entry.offset;
+        entry.vCount = (last ? v : next->vBase) - entry.vBase;
+        entry.vtCount = (last ? vt : next->vtBase) - entry.vtBase;
+        entry.vnCount = (last ? vn : next->vnBase) - entry.vnBase;
+    }
+    for (size_t i = 0; i < index.objects.size(); ++i) {
+        const bool last = (i + 1 == index.objects.size());
+        uint64_t nextFaces = last ? faces : index.objects[i + 1].faceCount;
+        index.objects[i].faceCount = nextFaces - index.objects[i].faceCount;
+    }
+    parallelFor(index.objects.size(), [&](size_t i) {
+        ObjObjectEntry& entry = index.objects[i];
+        entry.contentHash = hashBytes(data + entry.offset, entry.length);
+    }, numThreads);
+}
+
+bool writeObjIndex(const std::string& indexPath, const std::string& sourcePath, const ObjIndex& index, std::string* err) {
+    uint64_t sourceSize = 0, sourceHash = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime, err) || !hashFileContents(sourcePath, sourceHash, err)) {
+        return false;
+    }
+
+    const std::string tempPath = indexPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (err) *err = "impossible d'écrire " + tempPath;
+            return false;
+        }
+        out.write(kMagic, sizeof(kMagic));
+        writeU64(out, kObjIndexVersion);
+        writeU64(out, sourceSize);
+        writeU64(out, static_cast<uint64_t>(sourceMtime));
+        writeU64(out, sourceHash);
+        writeU64(out, index.totalV);
+        writeU64(out, index.totalVt);
+        writeU64(out, index.totalVn);
+        writeU64(out, index.objects.size());
+        for (const ObjObjectEntry& entry : index.objects) {
+            writeU64(out, entry.name.size());
+            out.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+            for (uint64_t value : {entry.offset, entry.length, entry.vBase, entry.vtBase, entry.vnBase,
+                                   entry.vCount, entry.vtCount, entry.vnCount, entry.faceCount, entry.contentHash}) {
+                writeU64(out, value);
+            }
+        }
+        if (!out) {
+            if (err) *err = "erreur d'écriture de " + tempPath;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), indexPath.c_str()) != 0) {
+        if (err) *err = "impossible de renommer " + tempPath;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool readObjIndex(const std::string& indexPath, const std::string& sourcePath, ObjIndex& index, std::string* err) {
+    MappedFile file;
+    if (!file.open(indexPath, err)) {
+        return false;
+    }
+    const char* p = file.data();
+    const char* end = p + file.size();
+    if (file.size() < sizeof(kMagic) || std::memcmp(p, kMagic, sizeof(kMagic)) != 0) {
+        if (err) *err = "fichier d'index invalide : " + indexPath;
+        return false;
+    }
+    p += sizeof(kMagic);
+
+    uint64_t version = 0, size = 0, mtime = 0, hash = 0, count = 0;
+    ObjIndex result;
+    if (!readU64(p, end, version) || version != kObjIndexVersion) {
+        if (err) *err = "version d'index obsolète : " + indexPath;
+        return false;
+    }
+    if (!readU64(p, end, size) || !readU64(p, end, mtime) || !readU64(p, end, hash) ||
+        !readU64(p, end, result.totalV) || !readU64(p, end, result.totalVt) || !readU64(p, end, result.totalVn) ||
+        !readU64(p, end, count)) {
+        if (err) *err = "index tronqué : " + indexPath;
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime, err)) {
+        return false;
+    }
+    bool upToDate = (sourceSize == size);
+    if (upToDate && static_cast<uint64_t>(sourceMtime) != mtime) {
+        uint64_t sourceHash = 0;
+        upToDate = hashFileContents(sourcePath, sourceHash, err) && sourceHash == hash;
+    }
+    if (!upToDate) {
+        if (err) *err = "la source a changé depuis l'écriture de l'index";
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        ObjObjectEntry entry;
+        uint64_t nameLength = 0;
+        if (!readU64(p, end, nameLength) || static_cast<uint64_t>(end - p) < nameLength) {
+            if (err) *err = "index tronqué : " + indexPath;
+            return false;
+        }
+        entry.name.assign(p, nameLength);
+        p += nameLength;
+        for (uint64_t* field : {&entry.offset, &entry.length, &entry.vBase, &entry.vtBase, &entry.vnBase,
+                                &entry.vCount, &entry.vtCount, &entry.vnCount, &entry.faceCount, &entry.contentHash}) {
+            if (!readU64(p, end, *field)) {
+                if (err) *err = "index tronqué : " + indexPath;
+                return false;
+            }
+        }
+        result.objects.push_back(entry);
+    }
+    index = std::move(result);
+    return true;
+}
+
+bool loadOrBuildObjIndex(const std::string& sourcePath, ObjIndex& index, std::string* err) {
+    const std::string indexPath = objIndexPath(sourcePath);
+    if (readObjIndex(indexPath, sourcePath, index, nullptr)) {
+        return true;
+    }
+
+    MappedFile file;
+    if (!file.open(sourcePath, err)) {
+        return false;
+    }
+    buildObjIndex(file.data(), file.size(), index);
+
+    // Un index non enregistré (dossier en lecture seule) reste utilisable pour cette session
+    writeObjIndex(indexPath, sourcePath, index, nullptr);
+    return true;
+}
+
+std::vector<size_t> findObjects(const ObjIndex& index, const std::vector<std::string>& names) {
+    std::vector<size_t> selected;
+    for (size_t i = 0; i < index.objects.size(); ++i) {
+        const std::string& objectName = index.objects[i].name;
+        for (const std::string& name : names) {
+            bool prefix = !name.empty() && name.back() == '*';
+            bool match = prefix ? objectName.compare(0, name.size() - 1, name, 0, name.size() - 1) == 0
+                                : objectName == name;
+            if (match) {
+                selected.push_back(i);
+                break;
+            }
+        }
+    }
+    return selected;
+}
+
+std::vector<bool> findUnchangedObjects(const ObjIndex& previous, const ObjIndex& current) {
+    std::unordered_multimap<std::string, const ObjObjectEntry*> byName;
+    for (const ObjObjectEntry& entry : previous.objects) {
+        byName.emplace(entry.name, &entry);
+    }
+    std::vector<bool> unchanged(current.objects.size(), false);
+    for (size_t i = 0; i < current.objects.size(); ++i) {
+        const ObjObjectEntry& entry = current.objects[i];
+        auto range = byName.equal_range(entry.name);
+        for (auto it = range.first; it != range.second; ++it) {
+            const ObjObjectEntry& old = *it->second;
+            if (old.contentHash == entry.contentHash && old.length == entry.length && old.vBase == entry.vBase &&
+                old.vtBase == entry.vtBase && old.vnBase == entry.vnBase) {
+                unchanged[i] = true;
+                break;
+            }
+        }
+    }
+    return unchanged;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Index des blocs `o` d'un fichier OBJ : position du bloc dans le fichier et nombre de v/vt/vn
+// définis avant lui, ce qui suffit pour analyser un objet seul sans lire le reste du fichier.
+struct ObjObjectEntry {
+    std::string name;
+    uint64_t offset = 0; // premier octet de la ligne `o`
+    uint64_t length = 0; // jusqu'au bloc suivant
+    uint64_t vBase = 0;  // nombre de v, vt, vn définis avant le bloc
+    uint64_t vtBase = 0;
+    uint64_t vnBase = 0;
+    uint64_t vCount = 0; // nombre de v, vt, vn, f dans le bloc
+    uint64_t vtCount = 0;
+    uint64_t vnCount = 0;
+    uint64_t faceCount = 0;
+    uint64_t contentHash = 0; // empreinte des octets du bloc, pour repérer les objets modifiés
+};
+
+struct ObjIndex {
+    std::vector<ObjObjectEntry> objects;
+    uint64_t totalV = 0;
+    uint64_t totalVt = 0;
+    uint64_t totalVn = 0;
+
+    // Indice du bloc contenant le v (resp. vt, vn) d'indice global donné (0-based)
+    size_t objectOfV(uint64_t index) const;
+    size_t objectOfVt(uint64_t index) const;
+    size_t objectOfVn(uint64_t index) const;
+};
+
+const uint32_t kObjIndexVersion = 2;
+
+std::string objIndexPath(const std::string& sourcePath);
+
+// Pré-analyse rapide (en parallèle) : seules les premières lettres de chaque ligne sont lues
+void buildObjIndex(const char* data, size_t size, ObjIndex& index, unsigned int numThreads = 0);
+
+bool writeObjIndex(const std::string& indexPath, const std::string& sourcePath, const ObjIndex& index, std::string* err);
+bool readObjIndex(const std::string& indexPath, const std::string& sourcePath, ObjIndex& index, std::string* err);
+
+// Relit l'index à côté du fichier s'il est à jour, sinon le reconstruit et l'enregistre
+bool loadOrBuildObjIndex(const std::string& sourcePath, ObjIndex& index, std::string* err);
+
+// Pour chaque objet de `current`, vrai s'il figure à l'identique dans `previous` : même nom, même
+// contenu et mêmes bases v/vt/vn (des indices absolus désigneraient sinon d'autres sommets)
+std::vector<bool> findUnchangedObjects(const ObjIndex& previous, const ObjIndex& current);
+
+// Sélectionne les objets par nom ; un nom terminé par '*' désigne un préfixe (ex. "smallwing*")
+std::vector<size_t> findObjects(const ObjIndex& index, const std::vector<std::string>& names);
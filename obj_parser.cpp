@@ -0,0 +1,545 @@
+#include "obj_parser.h"
+#include "mapped_file.h"
+#include "obj_index.h"
+#include "obj_tokenizer.h"
+#include "parallel.h"
+#include "tiny_obj_loader.h"
+
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <streambuf>
+#include <unordered_map>
+
+namespace {
+
+const int kMissingIndex = INT_MIN;
+
+enum : unsigned char {
+    kRelativeV = 1,
+    kRelativeVt = 2,
+    kRelativeVn = 4
+};
+
+// Coin de face tel que lu dans un bloc : indices 0-based, relatifs au début du bloc
+// lorsque l'OBJ utilise des indices négatifs.
+struct FaceCorner {
+    int v;
+    int vt;
+    int vn;
+    unsigned char relative;
+};
+
+struct ObjectMarker {
+    std::string name;
+    size_t firstFace;
+};
+
+struct ChunkData {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<FaceCorner> corners;
+    std::vector<size_t> faceStarts;
+    std::vector<ObjectMarker> objects;
+
+    size_t faceCount() const { return faceStarts.size(); }
+    size_t faceEnd(size_t f) const { return f + 1 < faceStarts.size() ? faceStarts[f + 1] : corners.size(); }
+};
+
+int resolveIndex(int raw, size_t localCount, unsigned char flag, unsigned char& relative) {
+    if (raw > 0) {
+        return raw - 1;
+    }
+    if (raw < 0) {
+        relative |= flag;
+        return static_cast<int>(localCount) + raw;
+    }
+    return kMissingIndex;
+}
+
+void onVertex(void* userData, tinyobj::real_t x, tinyobj::real_t y, tinyobj::real_t z, tinyobj::real_t) {
+    ChunkData* chunk = static_cast<ChunkData*>(userData);
+    chunk->positions.insert(chunk->positions.end(), {float(x), float(y), float(z)});
+}
+
+void onNormal(void* userData, tinyobj::real_t x, tinyobj::real_t y, tinyobj::real_t z) {
+    ChunkData* chunk = static_cast<ChunkData*>(userData);
+    chunk->normals.insert(chunk->normals.end(), {float(x), float(y), float(z)});
+}
+
+void onTexcoord(void* userData, tinyobj::real_t u, tinyobj::real_t v, tinyobj::real_t) {
+    ChunkData* chunk = static_cast<ChunkData*>(userData);
+    chunk->texcoords.insert(chunk->texcoords.end(), {float(u), float(v)});
+}
+
+void onFace(void* userData, tinyobj::index_t* indices, int numIndices) {
+    ChunkData* chunk = static_cast<ChunkData*>(userData);
+    chunk->faceStarts.push_back(chunk->corners.size());
+    for (int i = 0; i < numIndices; ++i) {
+        FaceCorner corner;
+        corner.relative = 0;
+        corner.v = resolveIndex(indices[i].vertex_index, chunk->positions.size() / 3, kRelativeV, corner.relative);
+        corner.vt = resolveIndex(indices[i].texcoord_index, chunk->texcoords.size() / 2, kRelativeVt, corner.relative);
+        corner.vn = resolveIndex(indices[i].normal_index, chunk->normals.size() / 3, kRelativeVn, corner.relative);
+        chunk->corners.push_back(corner);
+    }
+}
+
+void onObject(void* userData, const char* name) {
+    ChunkData* chunk = static_cast<ChunkData*>(userData);
+    std::string objectName(name);
+    while (!objectName.empty() && (objectName.back() == ' ' || objectName.back() == '\t' || objectName.back() == '\r')) {
+        objectName.pop_back();
+    }
+    chunk->objects.push_back({objectName, chunk->faceCount()});
+}
+
+// Analyse un bloc de lignes directement sur les octets projetés, sans copie de ligne
+void tokenizeChunk(const char* begin, const char* end, ChunkData& chunk) {
+    ObjCursor cursor(begin, end);
+    while (!cursor.atEnd()) {
+        cursor.skipSpaces();
+        float values[3];
+
+        if (cursor.keyword("v")) {
+            cursor.parseFloat3(values);
+            chunk.positions.insert(chunk.positions.end(), values, values + 3);
+        } else if (cursor.keyword("vn")) {
+            cursor.parseFloat3(values);
+            chunk.normals.insert(chunk.normals.end(), values, values + 3);
+        } else if (cursor.keyword("vt")) {
+            cursor.parseFloat3(values);
+            chunk.texcoords.insert(chunk.texcoords.end(), values, values + 2);
+        } else if (cursor.keyword("f")) {
+            size_t firstCorner = chunk.corners.size();
+            cursor.skipSpaces();
+            while (!cursor.atLineEnd()) {
+                int v = 0, vt = 0, vn = 0;
+                if (!cursor.parseInt(v)) {
+                    break;
+                }
+                if (!cursor.atEnd() && *cursor.p == '/') {
+                    ++cursor.p;
+                    if (!cursor.atEnd() && *cursor.p != '/') {
+                        cursor.parseInt(vt);
+                    }
+                    if (!cursor.atEnd() && *cursor.p == '/') {
+                        ++cursor.p;
+                        cursor.parseInt(vn);
+                    }
+                }
+                FaceCorner corner;
+                corner.relative = 0;
+                corner.v = resolveIndex(v, chunk.positions.size() / 3, kRelativeV, corner.relative);
+                corner.vt = resolveIndex(vt, chunk.texcoords.size() / 2, kRelativeVt, corner.relative);
+                corner.vn = resolveIndex(vn, chunk.normals.size() / 3, kRelativeVn, corner.relative);
+                chunk.corners.push_back(corner);
+                cursor.skipSpaces();
+            }
+            if (chunk.corners.size() > firstCorner) {
+                chunk.faceStarts.push_back(firstCorner);
+            }
+        } else if (cursor.keyword("o")) {
+            std::string_view name = cursor.restOfLine();
+            chunk.objects.push_back({std::string(name), chunk.faceCount()});
+        }
+        cursor.nextLine();
+    }
+}
+
+// Début de la prochaine ligne `o` après la ligne courante, ou end s'il n'y en a plus
+const char* findNextObject(const char* p, const char* end) {
+    while (p < end) {
+        const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!newline) {
+            return end;
+        }
+        p = static_cast<const char*>(newline) + 1;
+        ObjCursor cursor(p, end);
+        cursor.skipSpaces();
+        if (cursor.keyword("o")) {
+            return p;
+        }
+    }
+    return end;
+}
+
+struct FaceSpan {
+    size_t chunk;
+    size_t firstFace;
+    size_t endFace;
+};
+
+struct ObjectRange {
+    std::string name;
+    std::vector<FaceSpan> spans;
+};
+
+// Associe les faces de chaque bloc aux objets `o`, un objet pouvant chevaucher plusieurs blocs
+std::vector<ObjectRange> collectObjects(const std::vector<ChunkData>& chunks) {
+    std::vector<ObjectRange> objects;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const ChunkData& chunk = chunks[c];
+        size_t face = 0;
+        for (size_t m = 0; m <= chunk.objects.size(); ++m) {
+            size_t end = m < chunk.objects.size() ? chunk.objects[m].firstFace : chunk.faceCount();
+            if (end > face) {
+                if (objects.empty()) {
+                    objects.push_back({"defaultobject", {}});
+                }
+                objects.back().spans.push_back({c, face, end});
+            }
+            if (m < chunk.objects.size()) {
+                objects.push_back({chunk.objects[m].name, {}});
+            }
+            face = end;
+        }
+    }
+    return objects;
+}
+
+struct CornerKey {
+    int v;
+    int vt;
+    int vn;
+
+    bool operator==(const CornerKey& other) const { return v == other.v && vt == other.vt && vn == other.vn; }
+};
+
+struct CornerKeyHash {
+    size_t operator()(const CornerKey& key) const {
+        size_t h = static_cast<size_t>(static_cast<unsigned int>(key.v)) * 73856093u;
+        h ^= static_cast<size_t>(static_cast<unsigned int>(key.vt)) * 19349663u;
+        h ^= static_cast<size_t>(static_cast<unsigned int>(key.vn)) * 83492791u;
+        return h;
+    }
+};
+
+struct GlobalAttributes {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<size_t> vBase;
+    std::vector<size_t> vtBase;
+    std::vector<size_t> vnBase;
+    // Indice global du premier attribut stocké, non nul quand seule une partie du fichier est chargée
+    size_t vFirst = 0;
+    size_t vtFirst = 0;
+    size_t vnFirst = 0;
+};
+
+int toGlobal(int index, bool relative, size_t base) {
+    if (index == kMissingIndex) {
+        return kMissingIndex;
+    }
+    return relative ? static_cast<int>(base) + index : index;
+}
+
+// Triangule les faces d'un objet et fusionne les coins partageant le même triplet v/vt/vn
+bool buildMesh(const ObjectRange& object, const std::vector<ChunkData>& chunks, const GlobalAttributes& attributes,
+               ObjMesh& mesh, std::string& error) {
+    mesh.name = object.name;
+
+    const int vFirst = static_cast<int>(attributes.vFirst);
+    const int vtFirst = static_cast<int>(attributes.vtFirst);
+    const int vnFirst = static_cast<int>(attributes.vnFirst);
+    const int numPositions = static_cast<int>(attributes.positions.size() / 3);
+    const int numTexcoords = static_cast<int>(attributes.texcoords.size() / 2);
+    const int numNormals = static_cast<int>(attributes.normals.size() / 3);
+    bool hasNormals = false;
+    bool hasTexcoords = false;
+
+    std::unordered_map<CornerKey, unsigned int, CornerKeyHash> vertexMap;
+    std::vector<unsigned int> faceVertices;
+
+    for (const FaceSpan& span : object.spans) {
+        const ChunkData& chunk = chunks[span.chunk];
+        for (size_t f = span.firstFace; f < span.endFace; ++f) {
+            faceVertices.clear();
+            for (size_t c = chunk.faceStarts[f]; c < chunk.faceEnd(f); ++c) {
+                const FaceCorner& corner = chunk.corners[c];
+                CornerKey key;
+                key.v = toGlobal(corner.v, corner.relative & kRelativeV, attributes.vBase[span.chunk]);
+                key.vt = toGlobal(corner.vt, corner.relative & kRelativeVt, attributes.vtBase[span.chunk]);
+                key.vn = toGlobal(corner.vn, corner.relative & kRelativeVn, attributes.vnBase[span.chunk]);
+
+                if (key.v < vFirst || key.v - vFirst >= numPositions ||
+                    (key.vt != kMissingIndex && (key.vt < vtFirst || key.vt - vtFirst >= numTexcoords)) ||
+                    (key.vn != kMissingIndex && (key.vn < vnFirst || key.vn - vnFirst >= numNormals))) {
+                    error = "indice de face hors limites dans l'objet " + object.name;
+                    return false;
+                }
+
+                auto inserted = vertexMap.emplace(key, static_cast<unsigned int>(mesh.vertexCount()));
+                if (inserted.second) {
+                    const float* p = &attributes.positions[size_t(key.v - vFirst) * 3];
+                    mesh.positions.insert(mesh.positions.end(), p, p + 3);
+                    if (key.vn != kMissingIndex) {
+                        const float* n = &attributes.normals[size_t(key.vn - vnFirst) * 3];
+                        mesh.normals.insert(mesh.normals.end(), n, n + 3);
+                        hasNormals = true;
+                    } else {
+                        mesh.normals.insert(mesh.normals.end(), {0.0f, 0.0f, 0.0f});
+                    }
+                    if (key.vt != kMissingIndex) {
+                        const float* t = &attributes.texcoords[size_t(key.vt - vtFirst) * 2];
+                        mesh.texcoords.insert(mesh.texcoords.end(), {t[0], 1.0f - t[1]});
+                        hasTexcoords = true;
+                    } else {
+                        mesh.texcoords.insert(mesh.texcoords.end(), {0.0f, 0.0f});
+                    }
+                }
+                faceVertices.push_back(inserted.first->second);
+            }
+
+            for (size_t k = 2; k < faceVertices.size(); ++k) {
+                mesh.indices.insert(mesh.indices.end(), {faceVertices[0], faceVertices[k - 1], faceVertices[k]});
+            }
+        }
+    }
+
+    if (!hasNormals) {
+        mesh.normals.clear();
+    }
+    if (!hasTexcoords) {
+        mesh.texcoords.clear();
+    }
+    return true;
+}
+
+// Bases globales des indices de chaque bloc, concaténation des attributs puis construction des meshes
+bool assembleModel(const std::vector<ChunkData>& chunks, ObjModel& model, std::string* err, unsigned int numThreads) {
+    const size_t numChunks = chunks.size();
+    GlobalAttributes attributes;
+    size_t numPositions = 0, numTexcoords = 0, numNormals = 0;
+    for (const ChunkData& chunk : chunks) {
+        attributes.vBase.push_back(numPositions);
+        attributes.vtBase.push_back(numTexcoords);
+        attributes.vnBase.push_back(numNormals);
+        numPositions += chunk.positions.size();
+        numTexcoords += chunk.texcoords.size();
+        numNormals += chunk.normals.size();
+    }
+    attributes.positions.resize(numPositions);
+    attributes.texcoords.resize(numTexcoords);
+    attributes.normals.resize(numNormals);
+    parallelFor(numChunks, [&](size_t c) {
+        const ChunkData& chunk = chunks[c];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), attributes.positions.begin() + attributes.vBase[c]);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), attributes.texcoords.begin() + attributes.vtBase[c]);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), attributes.normals.begin() + attributes.vnBase[c]);
+    }, numThreads);
+    for (size_t c = 0; c < numChunks; ++c) {
+        attributes.vBase[c] /= 3;
+        attributes.vtBase[c] /= 2;
+        attributes.vnBase[c] /= 3;
+    }
+
+    const std::vector<ObjectRange> objects = collectObjects(chunks);
+    std::vector<ObjMesh> meshes(objects.size());
+    std::vector<std::string> errors(objects.size());
+    parallelFor(objects.size(), [&](size_t i) {
+        buildMesh(objects[i], chunks, attributes, meshes[i], errors[i]);
+    }, numThreads);
+
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            if (err) *err = error;
+            return false;
+        }
+    }
+
+    model.meshes.clear();
+    for (ObjMesh& mesh : meshes) {
+        if (!mesh.indices.empty()) {
+            model.meshes.push_back(std::move(mesh));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool loadObjParallel(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads) {
+    // Fichier projeté en mémoire : les blocs sont lus sur place, sans copie du texte
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    const char* text = file.data();
+
+    const std::vector<size_t> bounds = splitAtLines(text, file.size(), numThreads);
+    const size_t numChunks = bounds.size() - 1;
+    std::vector<ChunkData> chunks(numChunks);
+
+    tinyobj::callback_t callbacks;
+    callbacks.vertex_cb = onVertex;
+    callbacks.normal_cb = onNormal;
+    callbacks.texcoord_cb = onTexcoord;
+    callbacks.index_cb = onFace;
+    callbacks.object_cb = onObject;
+
+    parallelFor(numChunks, [&](size_t c) {
+        MemoryStreamBuf buffer(text + bounds[c], text + bounds[c + 1]);
+        std::istream stream(&buffer);
+        tinyobj::LoadObjWithCallback(stream, callbacks, &chunks[c]);
+    }, numThreads);
+
+    return assembleModel(chunks, model, err, numThreads);
+}
+
+bool parseObjBuffer(const char* data, size_t size, ObjModel& model, std::string* err, unsigned int numThreads) {
+    const std::vector<size_t> bounds = splitAtLines(data, size, numThreads);
+    const size_t numChunks = bounds.size() - 1;
+    std::vector<ChunkData> chunks(numChunks);
+
+    parallelFor(numChunks, [&](size_t c) {
+        tokenizeChunk(data + bounds[c], data + bounds[c + 1], chunks[c]);
+    }, numThreads);
+
+    return assembleModel(chunks, model, err, numThreads);
+}
+
+bool loadObjMapped(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    return parseObjBuffer(file.data(), file.size(), model, err, numThreads);
+}
+
+bool streamObjMeshes(const std::string& path, const std::function<bool(ObjMesh&)>& onMesh, std::string* err) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+
+    // Les attributs de tous les objets déjà lus restent accessibles aux faces des suivants
+    GlobalAttributes attributes;
+    attributes.vBase.assign(1, 0);
+    attributes.vtBase.assign(1, 0);
+    attributes.vnBase.assign(1, 0);
+    std::vector<ChunkData> block(1);
+
+    const char* end = file.data() + file.size();
+    for (const char* p = file.data(); p < end;) {
+        const char* next = findNextObject(p, end);
+        block[0] = ChunkData();
+        tokenizeChunk(p, next, block[0]);
+        p = next;
+
+        attributes.vBase[0] = attributes.positions.size() / 3;
+        attributes.vtBase[0] = attributes.texcoords.size() / 2;
+        attributes.vnBase[0] = attributes.normals.size() / 3;
+        attributes.positions.insert(attributes.positions.end(), block[0].positions.begin(), block[0].positions.end());
+        attributes.texcoords.insert(attributes.texcoords.end(), block[0].texcoords.begin(), block[0].texcoords.end());
+        attributes.normals.insert(attributes.normals.end(), block[0].normals.begin(), block[0].normals.end());
+
+        for (const ObjectRange& object : collectObjects(block)) {
+            ObjMesh mesh;
+            std::string error;
+            if (!buildMesh(object, block, attributes, mesh, error)) {
+                if (err) *err = error;
+                return false;
+            }
+            if (!mesh.indices.empty() && !onMesh(mesh)) {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+bool loadObjObjects(const std::string& path, const ObjIndex& index, const std::vector<size_t>& selected,
+                    ObjModel& model, std::string* err, unsigned int numThreads) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    for (size_t i : selected) {
+        if (i >= index.objects.size() || index.objects[i].offset + index.objects[i].length > file.size()) {
+            if (err) *err = "index d'objets incohérent avec " + path;
+            return false;
+        }
+    }
+
+    auto tokenizeEntry = [&](size_t i, ChunkData& chunk) {
+        const char* begin = file.data() + index.objects[i].offset;
+        tokenizeChunk(begin, begin + index.objects[i].length, chunk);
+    };
+
+    std::vector<std::vector<ObjMesh>> meshes(selected.size());
+    std::vector<std::string> errors(selected.size());
+    parallelFor(selected.size(), [&](size_t s) {
+        const size_t i = selected[s];
+        const ObjObjectEntry& entry = index.objects[i];
+        std::vector<ChunkData> block(1);
+        tokenizeEntry(i, block[0]);
+
+        // Étendue des attributs référencés : en général le bloc lui-même, mais une face peut
+        // utiliser des sommets définis dans des objets précédents
+        size_t first = i, last = i;
+        for (const FaceCorner& corner : block[0].corners) {
+            int v = toGlobal(corner.v, corner.relative & kRelativeV, entry.vBase);
+            int vt = toGlobal(corner.vt, corner.relative & kRelativeVt, entry.vtBase);
+            int vn = toGlobal(corner.vn, corner.relative & kRelativeVn, entry.vnBase);
+            if (v >= 0 && (uint64_t(v) < entry.vBase || uint64_t(v) >= entry.vBase + entry.vCount)) {
+                first = std::min(first, index.objectOfV(uint64_t(v)));
+                last = std::max(last, index.objectOfV(uint64_t(v)));
+            }
+            if (vt >= 0 && (uint64_t(vt) < entry.vtBase || uint64_t(vt) >= entry.vtBase + entry.vtCount)) {
+                first = std::min(first, index.objectOfVt(uint64_t(vt)));
+                last = std::max(last, index.objectOfVt(uint64_t(vt)));
+            }
+            if (vn >= 0 && (uint64_t(vn) < entry.vnBase || uint64_t(vn) >= entry.vnBase + entry.vnCount)) {
+                first = std::min(first, index.objectOfVn(uint64_t(vn)));
+                last = std::max(last, index.objectOfVn(uint64_t(vn)));
+            }
+        }
+
+        GlobalAttributes attributes;
+        attributes.vBase.assign(1, entry.vBase);
+        attributes.vtBase.assign(1, entry.vtBase);
+        attributes.vnBase.assign(1, entry.vnBase);
+        attributes.vFirst = index.objects[first].vBase;
+        attributes.vtFirst = index.objects[first].vtBase;
+        attributes.vnFirst = index.objects[first].vnBase;
+        for (size_t j = first; j <= last; ++j) {
+            ChunkData support;
+            if (j != i) {
+                tokenizeEntry(j, support);
+            }
+            const ChunkData& source = (j == i) ? block[0] : support;
+            attributes.positions.insert(attributes.positions.end(), source.positions.begin(), source.positions.end());
+            attributes.texcoords.insert(attributes.texcoords.end(), source.texcoords.begin(), source.texcoords.end());
+            attributes.normals.insert(attributes.normals.end(), source.normals.begin(), source.normals.end());
+        }
+
+        for (const ObjectRange& object : collectObjects(block)) {
+            ObjMesh mesh;
+            if (!buildMesh(object, block, attributes, mesh, errors[s])) {
+                return;
+            }
+            if (!mesh.indices.empty()) {
+                meshes[s].push_back(std::move(mesh));
+            }
+        }
+    }, numThreads);
+
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            if (err) *err = error;
+            return false;
+        }
+    }
+
+    model.meshes.clear();
+    for (std::vector<ObjMesh>& objectMeshes : meshes) {
+        for (ObjMesh& mesh : objectMeshes) {
+            model.meshes.push_back(std::move(mesh));
+        }
+    }
+    return true;
+}
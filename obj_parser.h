@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mesh_view.h"
+
+struct ObjIndex;
+
+// Mesh indexé produit par les chargeurs OBJ natifs (un mesh par bloc `o`).
+// Les faces sont triangulées et les UV inversées comme avec aiProcess_FlipUVs.
+struct ObjMesh {
+    std::string name;
+    std::vector<float> positions; // xyz par sommet
+    std::vector<float> normals;   // xyz par sommet, vide si absent
+    std::vector<float> texcoords; // uv par sommet, vide si absent
+    std::vector<unsigned int> indices; // 3 indices par triangle
+
+    size_t vertexCount() const { return positions.size() / 3; }
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    MeshView view() const {
+        MeshView v;
+        v.name = name;
+        v.positions = positions.data();
+        v.normals = normals.empty() ? nullptr : normals.data();
+        v.texcoords = texcoords.empty() ? nullptr : texcoords.data();
+        v.indices = indices.data();
+        v.vertexCount = vertexCount();
+        v.indexCount = indices.size();
+        return v;
+    }
+};
+
+struct ObjModel {
+    std::vector<ObjMesh> meshes;
+
+    std::vector<MeshView> views() const {
+        std::vector<MeshView> result;
+        result.reserve(meshes.size());
+        for (const ObjMesh& mesh : meshes) {
+            result.push_back(mesh.view());
+        }
+        return result;
+    }
+};
+
+// Charge un fichier OBJ en découpant le texte en blocs de lignes analysés en parallèle
+// par tinyobj::LoadObjWithCallback, puis en recollant les espaces d'indices v/vt/vn globaux.
+// numThreads = 0 utilise tous les coeurs.
+bool loadObjParallel(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads = 0);
+
+// Projette le fichier en mémoire (mmap) et l'analyse directement sur les octets projetés,
+// sans copie ni allocation par ligne ; les blocs de lignes sont analysés en parallèle.
+bool loadObjMapped(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads = 0);
+
+// Analyse un fichier OBJ déjà en mémoire, comme loadObjMapped
+bool parseObjBuffer(const char* data, size_t size, ObjModel& model, std::string* err, unsigned int numThreads = 0);
+
+// Analyse le fichier dans l'ordre et transmet chaque objet à onMesh dès que son bloc `o` est terminé,
+// sans attendre la fin du fichier. onMesh peut prendre le mesh (std::move) et retourne false pour arrêter.
+bool streamObjMeshes(const std::string& path, const std::function<bool(ObjMesh&)>& onMesh, std::string* err);
+
+// Charge uniquement les objets d'indices `selected` dans l'index (voir obj_index.h) : seuls leurs blocs
+// sont analysés, plus les blocs précédents dont leurs faces utilisent des sommets.
+bool loadObjObjects(const std::string& path, const ObjIndex& index, const std::vector<size_t>& selected,
+                    ObjModel& model, std::string* err, unsigned int numThreads = 0);
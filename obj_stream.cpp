@@ -0,0 +1,156 @@
+#include "obj_stream.h"
+
+#include <utility>
+
+#include "parallel.h"
+#include "path_utils.h"
+
+ObjStreamLoader::~ObjStreamLoader() {
+    cancelled_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ObjStreamLoader::start(const std::string& path) {
+    finished_ = false;
+    cancelled_ = false;
+    thread_ = std::thread(&ObjStreamLoader::run, this, path);
+}
+
+std::vector<ObjMesh> ObjStreamLoader::takeReady() {
+    std::vector<ObjMesh> meshes;
+    std::lock_guard<std::mutex> lock(mutex_);
+    meshes.swap(ready_);
+    return meshes;
+}
+
+std::string ObjStreamLoader::error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void ObjStreamLoader::run(const std::string& path) {
+    std::string error;
+    streamObjMeshes(path, [this](ObjMesh& mesh) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(std::move(mesh));
+        return !cancelled_;
+    }, &error);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = error;
+    }
+    finished_ = true;
+}
+
+ObjPartsLoader::~ObjPartsLoader() {
+    cancelled_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ObjPartsLoader::start(const std::vector<std::string>& paths, unsigned int numThreads) {
+    finished_ = false;
+    cancelled_ = false;
+    readingDone_ = false;
+    thread_ = std::thread(&ObjPartsLoader::run, this, paths, numThreads);
+}
+
+std::vector<ObjMesh> ObjPartsLoader::takeReady() {
+    std::vector<ObjMesh> meshes;
+    std::lock_guard<std::mutex> lock(mutex_);
+    meshes.swap(ready_);
+    return meshes;
+}
+
+std::string ObjPartsLoader::error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+BatchReadStats ObjPartsLoader::readStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readStats_;
+}
+
+void ObjPartsLoader::addError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ += (error_.empty() ? "" : "\n") + message;
+}
+
+void ObjPartsLoader::run(std::vector<std::string> paths, unsigned int numThreads) {
+    // Ce thread soumet les lectures ; les threads d'analyse consomment les fichiers au fil des complétions
+    std::vector<std::thread> parsers;
+    const unsigned int parserCount = workerCount(numThreads);
+    for (unsigned int t = 0; t < parserCount; ++t) {
+        parsers.emplace_back(&ObjPartsLoader::parseFiles, this, std::cref(paths));
+    }
+
+    BatchReadOptions options;
+    options.numThreads = numThreads;
+    BatchReadStats stats;
+    readFilesBatched(paths, [this, &paths](size_t index, std::vector<char>& data, const std::string& error) {
+        if (!error.empty()) {
+            addError(error);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.push_back({index, std::move(data)});
+        queueReady_.notify_one();
+    }, options, &stats);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        readingDone_ = true;
+    }
+    queueReady_.notify_all();
+    for (std::thread& parser : parsers) {
+        parser.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readStats_ = stats;
+    }
+    finished_ = true;
+}
+
+void ObjPartsLoader::parseFiles(const std::vector<std::string>& paths) {
+    for (;;) {
+        ReadFile file;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueReady_.wait(lock, [this] { return !queue_.empty() || readingDone_; });
+            if (queue_.empty()) {
+                return;
+            }
+            file = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        if (cancelled_) {
+            continue;
+        }
+
+        // Les fichiers sont déjà répartis entre les threads : chacun est analysé d'un seul tenant
+        ObjModel model;
+        std::string error;
+        if (!parseObjBuffer(file.data.data(), file.data.size(), model, &error, 1)) {
+            addError(paths[file.index] + " : " + error);
+            continue;
+        }
+        std::vector<char>().swap(file.data);
+        for (ObjMesh& mesh : model.meshes) {
+            if (mesh.name == "defaultobject") {
+                mesh.name = fileStem(paths[file.index]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ObjMesh& mesh : model.meshes) {
+            ready_.push_back(std::move(mesh));
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch_reader.h"
+#include "obj_parser.h"
+
+// Chargement progressif : un thread analyse le fichier OBJ dans l'ordre et publie chaque mesh
+// terminé ; la boucle de rendu récupère les meshes prêts sans jamais attendre.
+class ObjStreamLoader {
+public:
+    ObjStreamLoader() = default;
+    ~ObjStreamLoader();
+
+    ObjStreamLoader(const ObjStreamLoader&) = delete;
+    ObjStreamLoader& operator=(const ObjStreamLoader&) = delete;
+
+    void start(const std::string& path);
+
+    // Meshes publiés depuis le dernier appel (non bloquant)
+    std::vector<ObjMesh> takeReady();
+
+    bool isRunning() const { return thread_.joinable() && !finished_; }
+    bool isFinished() const { return finished_; }
+
+    // Message d'erreur du thread d'analyse, vide si aucune erreur (valide une fois terminé)
+    std::string error() const;
+
+private:
+    void run(const std::string& path);
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::vector<ObjMesh> ready_;
+    std::string error_;
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> cancelled_{false};
+};
+
+// Chargement d'une scène en plusieurs fichiers OBJ : toutes les lectures sont groupées par
+// readFilesBatched (io_uring ou pread), et chaque fichier lu est analysé par un groupe de threads
+// pendant que les suivants se lisent. Ses meshes sont publiés dès la fin de son analyse ; un mesh
+// sans `o` prend le nom du fichier.
+class ObjPartsLoader {
+public:
+    ObjPartsLoader() = default;
+    ~ObjPartsLoader();
+
+    ObjPartsLoader(const ObjPartsLoader&) = delete;
+    ObjPartsLoader& operator=(const ObjPartsLoader&) = delete;
+
+    void start(const std::vector<std::string>& paths, unsigned int numThreads = 0);
+
+    // Meshes publiés depuis le dernier appel (non bloquant)
+    std::vector<ObjMesh> takeReady();
+
+    bool isFinished() const { return finished_; }
+
+    // Erreurs des fichiers illisibles ou invalides, une par ligne ; les autres fichiers sont chargés
+    std::string error() const;
+
+    // Statistiques de lecture (valides une fois terminé)
+    BatchReadStats readStats() const;
+
+private:
+    struct ReadFile {
+        size_t index;
+        std::vector<char> data;
+    };
+
+    void run(std::vector<std::string> paths, unsigned int numThreads);
+    void parseFiles(const std::vector<std::string>& paths);
+    void addError(const std::string& message);
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::vector<ObjMesh> ready_;
+    std::string error_;
+    BatchReadStats readStats_;
+
+    // Fichiers lus en attente d'analyse
+    std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::deque<ReadFile> queue_;
+    bool readingDone_ = false;
+
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> cancelled_{false};
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+#include "float_parser.h"
+#include "parallel.h"
+
+// Flux en lecture seule sur une plage mémoire, sans copie (pour tinyobj::LoadObjWithCallback)
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char* begin, const char* end) {
+        char* b = const_cast<char*>(begin);
+        setg(b, b, const_cast<char*>(end));
+    }
+};
+
+// Curseur de lecture directement sur les octets d'un fichier OBJ (projeté en mémoire).
+// Aucune ligne n'est copiée : les jetons sont lus en place entre p et end.
+struct ObjCursor {
+    const char* p;
+    const char* end;
+
+    ObjCursor(const char* begin, const char* finish) : p(begin), end(finish) {}
+
+    bool atEnd() const { return p >= end; }
+
+    bool atLineEnd() const { return p >= end || *p == '\n' || *p == '\r' || *p == '#'; }
+
+    void skipSpaces() {
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+    }
+
+    // Passe au début de la ligne suivante
+    void nextLine() {
+        while (p < end && *p != '\n') {
+            ++p;
+        }
+        if (p < end) {
+            ++p;
+        }
+    }
+
+    // Teste si la ligne commence par le mot-clé suivi d'un espace, et le consomme
+    bool keyword(std::string_view word) {
+        size_t n = word.size();
+        if (static_cast<size_t>(end - p) <= n || std::string_view(p, n) != word || (p[n] != ' ' && p[n] != '\t')) {
+            return false;
+        }
+        p += n;
+        return true;
+    }
+
+    // Reste de la ligne, sans les espaces finaux
+    std::string_view restOfLine() {
+        skipSpaces();
+        const char* start = p;
+        while (p < end && *p != '\n' && *p != '\r') {
+            ++p;
+        }
+        const char* stop = p;
+        while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t')) {
+            --stop;
+        }
+        return std::string_view(start, static_cast<size_t>(stop - start));
+    }
+
+    bool parseInt(int& out) {
+        const char* s = p;
+        bool negative = false;
+        if (s < end && (*s == '-' || *s == '+')) {
+            negative = (*s == '-');
+            ++s;
+        }
+        if (s >= end || *s < '0' || *s > '9') {
+            return false;
+        }
+        int value = 0;
+        while (s < end && *s >= '0' && *s <= '9') {
+            const int digit = *s - '0';
+            if (value > (INT_MAX - digit) / 10) {
+                return false; // indice trop long pour un int : curseur laissé en place
+            }
+            value = value * 10 + digit;
+            ++s;
+        }
+        out = negative ? -value : value;
+        p = s;
+        return true;
+    }
+
+    bool parseFloat(float& out) {
+        const char* next = ::parseFloat(p, end, out);
+        if (!next) {
+            return false;
+        }
+        p = next;
+        return true;
+    }
+
+    // Jusqu'à trois composantes (v, vn, vt), les absentes valant 0
+    void parseFloat3(float values[3]) {
+        p = ::parseFloat3(p, end, values);
+    }
+};
+
+// Découpe le texte en blocs (au plus un par thread) se terminant sur une fin de ligne.
+// Retourne les bornes : le bloc i couvre [bounds[i], bounds[i + 1]).
+inline std::vector<size_t> splitAtLines(const char* data, size_t size, unsigned int numThreads) {
+    const size_t kMinChunkBytes = 256 * 1024;
+    size_t chunkCount = std::min<size_t>(workerCount(numThreads), size / kMinChunkBytes + 1);
+    std::vector<size_t> bounds(1, 0);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        size_t pos = std::max(size * i / chunkCount, bounds.back());
+        const void* newline = pos < size ? std::memchr(data + pos, '\n', size - pos) : nullptr;
+        if (!newline) {
+            break;
+        }
+        size_t next = static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+        if (next > bounds.back()) {
+            bounds.push_back(next);
+        }
+    }
+    bounds.push_back(size);
+    return bounds;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Nombre de threads de travail à utiliser (0 = tous les coeurs disponibles)
+inline unsigned int workerCount(unsigned int requested = 0) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// Exécute fn(i) pour i dans [0, count) sur plusieurs threads.
+// Les indices sont distribués dynamiquement pour équilibrer des tâches de tailles inégales.
+template <typename Fn>
+void parallelFor(size_t count, Fn fn, unsigned int numThreads = 0) {
+    if (count == 0) {
+        return;
+    }
+    unsigned int threads = static_cast<unsigned int>(std::min<size_t>(workerCount(numThreads), count));
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cctype>
+#include <cstring>
+#include <string>
+
+// Vrai si le chemin se termine par l'extension donnée (".stl", en minuscules), sans tenir compte de la casse
+inline bool hasExtension(const std::string& path, const char* extension) {
+    const size_t n = std::strlen(extension);
+    if (path.size() < n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(path[path.size() - n + i])) != extension[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nom du fichier sans dossier ni extension
+inline std::string fileStem(const std::string& path) {
+    size_t start = path.find_last_of('/');
+    start = start == std::string::npos ? 0 : start + 1;
+    size_t dot = path.find_last_of('.');
+    return path.substr(start, dot != std::string::npos && dot > start ? dot - start : std::string::npos);
+}
@@ -0,0 +1,486 @@
+#include "ply_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#include "mapped_file.h"
+#include "parallel.h"
+#include "path_utils.h"
+
+namespace {
+
+const size_t kVerticesPerTask = 64 * 1024;
+const size_t kFacesPerTask = 64 * 1024;
+
+enum class PlyType { Int8, Uint8, Int16, Uint16, Int32, Uint32, Float32, Float64, Invalid };
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    bool isList = false;
+    PlyType countType = PlyType::Invalid;
+    size_t offset = 0; // dans l'enregistrement, pour les éléments de taille fixe
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+    size_t stride = 0; // 0 si l'élément contient une liste
+
+    const PlyProperty* find(std::initializer_list<const char*> names) const {
+        for (const char* name : names) {
+            for (const PlyProperty& property : properties) {
+                if (property.name == name) {
+                    return &property;
+                }
+            }
+        }
+        return nullptr;
+    }
+};
+
+PlyType parseType(const std::string& name) {
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::Uint8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::Uint16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::Uint32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+size_t typeSize(PlyType type) {
+    switch (type) {
+        case PlyType::Int8:
+        case PlyType::Uint8: return 1;
+        case PlyType::Int16:
+        case PlyType::Uint16: return 2;
+        case PlyType::Int32:
+        case PlyType::Uint32:
+        case PlyType::Float32: return 4;
+        case PlyType::Float64: return 8;
+        default: return 0;
+    }
+}
+
+// Lecture d'une valeur, retournée dans l'ordre d'octets de la machine
+template <typename T>
+T load(const char* p, bool swap) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (swap) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+double readValue(const char* p, PlyType type, bool swap) {
+    switch (type) {
+        case PlyType::Int8: return load<int8_t>(p, swap);
+        case PlyType::Uint8: return load<uint8_t>(p, swap);
+        case PlyType::Int16: return load<int16_t>(p, swap);
+        case PlyType::Uint16: return load<uint16_t>(p, swap);
+        case PlyType::Int32: return load<int32_t>(p, swap);
+        case PlyType::Uint32: return load<uint32_t>(p, swap);
+        case PlyType::Float32: return load<float>(p, swap);
+        case PlyType::Float64: return load<double>(p, swap);
+        default: return 0.0;
+    }
+}
+
+// Indice de liste : entier sans passer par un double
+int64_t readIndex(const char* p, PlyType type, bool swap) {
+    switch (type) {
+        case PlyType::Int8: return load<int8_t>(p, swap);
+        case PlyType::Uint8: return load<uint8_t>(p, swap);
+        case PlyType::Int16: return load<int16_t>(p, swap);
+        case PlyType::Uint16: return load<uint16_t>(p, swap);
+        case PlyType::Int32: return load<int32_t>(p, swap);
+        case PlyType::Uint32: return load<uint32_t>(p, swap);
+        default: return -1;
+    }
+}
+
+bool hostIsLittleEndian() {
+    const uint16_t value = 1;
+    unsigned char first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+// En-tête texte jusqu'à "end_header" ; remplit les éléments et la position du premier octet binaire
+bool parseHeader(const char* data, size_t size, std::vector<PlyElement>& elements, bool& littleEndian,
+                 size_t& bodyOffset, std::string& error) {
+    const char* end = data + size;
+    const char* line = data;
+    bool first = true, formatSeen = false;
+    while (line < end) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        if (!newline) {
+            break;
+        }
+        std::string text(line, newline);
+        if (!text.empty() && text.back() == '\r') {
+            text.pop_back();
+        }
+        line = newline + 1;
+        std::istringstream tokens(text);
+        std::string keyword;
+        tokens >> keyword;
+
+        if (first) {
+            if (keyword != "ply") {
+                error = "fichier PLY invalide";
+                return false;
+            }
+            first = false;
+        } else if (keyword == "format") {
+            std::string format;
+            tokens >> format;
+            if (format == "ascii") {
+                error = "PLY ASCII non pris en charge par le chargeur binaire";
+                return false;
+            }
+            if (format != "binary_little_endian" && format != "binary_big_endian") {
+                error = "format PLY inconnu : " + format;
+                return false;
+            }
+            littleEndian = (format == "binary_little_endian");
+            formatSeen = true;
+        } else if (keyword == "element") {
+            PlyElement element;
+            tokens >> element.name >> element.count;
+            if (!tokens) {
+                error = "élément PLY invalide : " + text;
+                return false;
+            }
+            elements.push_back(element);
+        } else if (keyword == "property") {
+            if (elements.empty()) {
+                error = "propriété PLY hors élément";
+                return false;
+            }
+            PlyProperty property;
+            std::string type;
+            tokens >> type;
+            if (type == "list") {
+                std::string countType, itemType;
+                tokens >> countType >> itemType >> property.name;
+                property.isList = true;
+                property.countType = parseType(countType);
+                property.type = parseType(itemType);
+            } else {
+                property.type = parseType(type);
+                tokens >> property.name;
+            }
+            if (property.type == PlyType::Invalid || (property.isList && property.countType == PlyType::Invalid) ||
+                property.name.empty()) {
+                error = "propriété PLY invalide : " + text;
+                return false;
+            }
+            elements.back().properties.push_back(property);
+        } else if (keyword == "end_header") {
+            if (!formatSeen) {
+                error = "format PLY absent";
+                return false;
+            }
+            bodyOffset = static_cast<size_t>(line - data);
+            for (PlyElement& element : elements) {
+                size_t offset = 0;
+                bool fixed = true;
+                for (PlyProperty& property : element.properties) {
+                    property.offset = offset;
+                    fixed = fixed && !property.isList;
+                    offset += property.isList ? 0 : typeSize(property.type);
+                }
+                element.stride = fixed ? offset : 0;
+            }
+            return true;
+        }
+        // comment, obj_info : ignorés
+    }
+    error = "en-tête PLY incomplet";
+    return false;
+}
+
+// Taille d'un enregistrement contenant des listes, ou 0 s'il dépasse la fin
+size_t recordSize(const PlyElement& element, const char* p, const char* end, bool swap) {
+    size_t size = 0;
+    for (const PlyProperty& property : element.properties) {
+        if (!property.isList) {
+            size += typeSize(property.type);
+            continue;
+        }
+        const size_t countBytes = typeSize(property.countType);
+        if (static_cast<size_t>(end - p) < size + countBytes) {
+            return 0;
+        }
+        const int64_t count = readIndex(p + size, property.countType, swap);
+        if (count < 0) {
+            return 0;
+        }
+        size += countBytes + size_t(count) * typeSize(property.type);
+    }
+    return static_cast<size_t>(end - p) >= size ? size : 0;
+}
+
+struct Attribute {
+    const PlyProperty* property[3] = {nullptr, nullptr, nullptr};
+
+    bool present(int n) const {
+        for (int k = 0; k < n; ++k) {
+            if (!property[k]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Triplet (ou paire) de float32 contigus : copie directe possible
+    bool contiguousFloats(int n) const {
+        for (int k = 0; k < n; ++k) {
+            if (property[k]->type != PlyType::Float32 || property[k]->offset != property[0]->offset + k * 4) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+void readVertices(const PlyElement& element, const char* body, bool swap, ObjMesh& mesh, unsigned int numThreads) {
+    Attribute position, normal, texcoord;
+    position.property[0] = element.find({"x"});
+    position.property[1] = element.find({"y"});
+    position.property[2] = element.find({"z"});
+    normal.property[0] = element.find({"nx"});
+    normal.property[1] = element.find({"ny"});
+    normal.property[2] = element.find({"nz"});
+    texcoord.property[0] = element.find({"u", "s", "texture_u", "texture_s"});
+    texcoord.property[1] = element.find({"v", "t", "texture_v", "texture_t"});
+    const bool hasNormals = normal.present(3);
+    const bool hasTexcoords = texcoord.present(2);
+
+    const size_t count = element.count;
+    mesh.positions.resize(count * 3);
+    mesh.normals.resize(hasNormals ? count * 3 : 0);
+    mesh.texcoords.resize(hasTexcoords ? count * 2 : 0);
+    const bool copyPositions = !swap && position.contiguousFloats(3);
+    const bool copyNormals = hasNormals && !swap && normal.contiguousFloats(3);
+    const size_t stride = element.stride;
+
+    const size_t tasks = (count + kVerticesPerTask - 1) / kVerticesPerTask;
+    parallelFor(tasks, [&](size_t task) {
+        const size_t firstVertex = task * kVerticesPerTask;
+        const size_t lastVertex = std::min(count, firstVertex + kVerticesPerTask);
+        for (size_t v = firstVertex; v < lastVertex; ++v) {
+            const char* record = body + v * stride;
+            float* p = &mesh.positions[v * 3];
+            if (copyPositions) {
+                std::memcpy(p, record + position.property[0]->offset, 3 * sizeof(float));
+            } else {
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = static_cast<float>(readValue(record + position.property[k]->offset, position.property[k]->type, swap));
+                }
+            }
+            if (hasNormals) {
+                float* n = &mesh.normals[v * 3];
+                if (copyNormals) {
+                    std::memcpy(n, record + normal.property[0]->offset, 3 * sizeof(float));
+                } else {
+                    for (int k = 0; k < 3; ++k) {
+                        n[k] = static_cast<float>(readValue(record + normal.property[k]->offset, normal.property[k]->type, swap));
+                    }
+                }
+            }
+            if (hasTexcoords) {
+                float* t = &mesh.texcoords[v * 2];
+                t[0] = static_cast<float>(readValue(record + texcoord.property[0]->offset, texcoord.property[0]->type, swap));
+                t[1] = 1.0f - static_cast<float>(readValue(record + texcoord.property[1]->offset, texcoord.property[1]->type, swap));
+            }
+        }
+    }, numThreads);
+}
+
+// Lit les faces ; retourne le nombre d'octets consommés, ou 0 en cas d'erreur
+size_t readFaces(const PlyElement& element, const char* body, const char* end, bool swap, size_t vertexCount,
+                 std::vector<unsigned int>& indices, std::string& error, unsigned int numThreads) {
+    const PlyProperty* list = element.find({"vertex_indices", "vertex_index"});
+    if (!list || !list->isList) {
+        error = "faces PLY sans liste vertex_indices";
+        return 0;
+    }
+    const size_t countBytes = typeSize(list->countType);
+    const size_t indexBytes = typeSize(list->type);
+    if (element.count == 0) {
+        return 0;
+    }
+
+    // Pas fixe : la liste est la seule propriété et toutes les faces ont le même nombre de sommets
+    // que la première (vérifié en parallèle avant le décodage)
+    if (element.properties.size() == 1 && static_cast<size_t>(end - body) >= countBytes) {
+        const int64_t corners = readIndex(body, list->countType, swap);
+        const size_t stride = countBytes + size_t(std::max<int64_t>(corners, 0)) * indexBytes;
+        if (corners >= 3 && static_cast<size_t>(end - body) / stride >= element.count) {
+            const size_t tasks = (element.count + kFacesPerTask - 1) / kFacesPerTask;
+            std::atomic<bool> uniform(true);
+            parallelFor(tasks, [&](size_t task) {
+                const size_t last = std::min(element.count, (task + 1) * kFacesPerTask);
+                for (size_t f = task * kFacesPerTask; f < last && uniform; ++f) {
+                    if (readIndex(body + f * stride, list->countType, swap) != corners) {
+                        uniform = false;
+                    }
+                }
+            }, numThreads);
+
+            if (uniform) {
+                const size_t trianglesPerFace = size_t(corners) - 2;
+                indices.resize(element.count * trianglesPerFace * 3);
+                std::atomic<bool> valid(true);
+                parallelFor(tasks, [&](size_t task) {
+                    const size_t last = std::min(element.count, (task + 1) * kFacesPerTask);
+                    for (size_t f = task * kFacesPerTask; f < last; ++f) {
+                        const char* items = body + f * stride + countBytes;
+                        unsigned int* out = &indices[f * trianglesPerFace * 3];
+                        const int64_t first = readIndex(items, list->type, swap);
+                        int64_t previous = readIndex(items + indexBytes, list->type, swap);
+                        for (size_t k = 2; k < size_t(corners); ++k) {
+                            const int64_t current = readIndex(items + k * indexBytes, list->type, swap);
+                            if (first < 0 || previous < 0 || current < 0 || size_t(first) >= vertexCount ||
+                                size_t(previous) >= vertexCount || size_t(current) >= vertexCount) {
+                                valid = false;
+                            }
+                            *out++ = static_cast<unsigned int>(first);
+                            *out++ = static_cast<unsigned int>(previous);
+                            *out++ = static_cast<unsigned int>(current);
+                            previous = current;
+                        }
+                    }
+                }, numThreads);
+                if (!valid) {
+                    error = "indice de face PLY hors limites";
+                    return 0;
+                }
+                return element.count * stride;
+            }
+        }
+    }
+
+    // Cas général : enregistrements de tailles variables, lus dans l'ordre
+    const char* p = body;
+    indices.clear();
+    for (size_t f = 0; f < element.count; ++f) {
+        const size_t size = recordSize(element, p, end, swap);
+        if (size == 0) {
+            error = "faces PLY tronquées";
+            return 0;
+        }
+        const char* items = p;
+        for (const PlyProperty& property : element.properties) {
+            if (&property == list) {
+                break;
+            }
+            items += property.isList ? countBytes + size_t(readIndex(items, property.countType, swap)) * typeSize(property.type)
+                                     : typeSize(property.type);
+        }
+        const int64_t corners = readIndex(items, list->countType, swap);
+        items += countBytes;
+        for (int64_t k = 2; k < corners; ++k) {
+            const int64_t face[3] = {readIndex(items, list->type, swap),
+                                     readIndex(items + size_t(k - 1) * indexBytes, list->type, swap),
+                                     readIndex(items + size_t(k) * indexBytes, list->type, swap)};
+            for (int64_t index : face) {
+                if (index < 0 || size_t(index) >= vertexCount) {
+                    error = "indice de face PLY hors limites";
+                    return 0;
+                }
+                indices.push_back(static_cast<unsigned int>(index));
+            }
+        }
+        p += size;
+    }
+    return static_cast<size_t>(p - body);
+}
+
+} // namespace
+
+bool isPlyPath(const std::string& path) {
+    return hasExtension(path, ".ply");
+}
+
+bool loadPlyBinary(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    std::vector<PlyElement> elements;
+    bool littleEndian = true;
+    size_t offset = 0;
+    std::string error;
+    if (!parseHeader(file.data(), file.size(), elements, littleEndian, offset, error)) {
+        if (err) *err = error + " : " + path;
+        return false;
+    }
+    const bool swap = littleEndian != hostIsLittleEndian();
+    const char* end = file.data() + file.size();
+
+    ObjMesh mesh;
+    mesh.name = fileStem(path);
+    bool verticesRead = false;
+    for (const PlyElement& element : elements) {
+        const char* body = file.data() + offset;
+        const size_t available = file.size() - offset;
+        if (element.name == "vertex") {
+            if (element.stride == 0 || !element.find({"x"}) || !element.find({"y"}) || !element.find({"z"}) ||
+                available / element.stride < element.count) {
+                if (err) *err = "sommets PLY invalides ou tronqués : " + path;
+                return false;
+            }
+            readVertices(element, body, swap, mesh, numThreads);
+            offset += element.count * element.stride;
+            verticesRead = true;
+        } else if (element.name == "face") {
+            if (!verticesRead) {
+                if (err) *err = "faces PLY avant les sommets : " + path;
+                return false;
+            }
+            const size_t consumed = readFaces(element, body, end, swap, mesh.vertexCount(), mesh.indices, error, numThreads);
+            if (!error.empty()) {
+                if (err) *err = error + " : " + path;
+                return false;
+            }
+            offset += consumed;
+        } else if (element.stride > 0) {
+            // Élément inconnu de taille fixe : sauté d'un bloc
+            if (available / element.stride < element.count) {
+                if (err) *err = "élément PLY " + element.name + " tronqué : " + path;
+                return false;
+            }
+            offset += element.count * element.stride;
+        } else {
+            for (size_t i = 0; i < element.count; ++i) {
+                const size_t size = recordSize(element, file.data() + offset, end, swap);
+                if (size == 0) {
+                    if (err) *err = "élément PLY " + element.name + " tronqué : " + path;
+                    return false;
+                }
+                offset += size;
+            }
+        }
+    }
+
+    model.meshes.clear();
+    if (!mesh.indices.empty()) {
+        model.meshes.push_back(std::move(mesh));
+    } else if (verticesRead) {
+        if (err) *err = "PLY sans faces (nuage de points) : " + path;
+        return false;
+    }
+    return true;
+}
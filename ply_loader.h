@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include "obj_parser.h"
+
+// Chargeur PLY binaire (petit ou gros boutiste) pour les données de numérisation : l'en-tête texte est
+// analysé, puis les sommets (taille fixe) sont convertis en parallèle par blocs, avec une copie directe
+// des triplets de flottants quand x/y/z et nx/ny/nz sont contigus. Les faces de même nombre de sommets
+// sont décodées en parallèle à pas fixe, les autres séquentiellement (triangulation en éventail).
+// Les éléments inconnus sont ignorés. Le PLY ASCII n'est pas pris en charge (erreur : le laisser à Assimp).
+bool loadPlyBinary(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads = 0);
+
+// Vrai si le chemin désigne un fichier .ply (sans tenir compte de la casse)
+bool isPlyPath(const std::string& path);
@@ -0,0 +1,152 @@
+#include "scene_builder.h"
+
+#include <algorithm>
+
+aiMesh* createMesh(const MeshView& mesh) {
+    aiMesh* out = new aiMesh();
+    out->mName = aiString(std::string(mesh.name));
+    out->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    out->mMaterialIndex = 0;
+
+    const unsigned int numVertices = static_cast<unsigned int>(mesh.vertexCount);
+    out->mNumVertices = numVertices;
+    out->mVertices = new aiVector3D[numVertices];
+    for (unsigned int i = 0; i < numVertices; ++i) {
+        out->mVertices[i] = aiVector3D(mesh.positions[i * 3], mesh.positions[i * 3 + 1], mesh.positions[i * 3 + 2]);
+    }
+    if (mesh.normals) {
+        out->mNormals = new aiVector3D[numVertices];
+        for (unsigned int i = 0; i < numVertices; ++i) {
+            out->mNormals[i] = aiVector3D(mesh.normals[i * 3], mesh.normals[i * 3 + 1], mesh.normals[i * 3 + 2]);
+        }
+    }
+    if (mesh.texcoords) {
+        out->mNumUVComponents[0] = 2;
+        out->mTextureCoords[0] = new aiVector3D[numVertices];
+        for (unsigned int i = 0; i < numVertices; ++i) {
+            out->mTextureCoords[0][i] = aiVector3D(mesh.texcoords[i * 2], mesh.texcoords[i * 2 + 1], 0.0f);
+        }
+    }
+
+    const unsigned int numFaces = static_cast<unsigned int>(mesh.indexCount / 3);
+    out->mNumFaces = numFaces;
+    out->mFaces = new aiFace[numFaces];
+    for (unsigned int f = 0; f < numFaces; ++f) {
+        aiFace& face = out->mFaces[f];
+        face.mNumIndices = 3;
+        face.mIndices = new unsigned int[3];
+        face.mIndices[0] = mesh.indices[f * 3];
+        face.mIndices[1] = mesh.indices[f * 3 + 1];
+        face.mIndices[2] = mesh.indices[f * 3 + 2];
+    }
+    return out;
+}
+
+aiScene* createScene(const std::vector<aiMesh*>& meshes) {
+    aiScene* scene = new aiScene();
+    const unsigned int numMeshes = static_cast<unsigned int>(meshes.size());
+
+    scene->mNumMeshes = numMeshes;
+    scene->mMeshes = new aiMesh*[numMeshes];
+    std::copy(meshes.begin(), meshes.end(), scene->mMeshes);
+
+    scene->mRootNode = new aiNode();
+    scene->mRootNode->mName = aiString(std::string("root"));
+    scene->mRootNode->mNumMeshes = numMeshes;
+    scene->mRootNode->mMeshes = new unsigned int[numMeshes];
+    for (unsigned int i = 0; i < numMeshes; ++i) {
+        scene->mRootNode->mMeshes[i] = i;
+    }
+    return scene;
+}
+
+aiScene* createScene(const std::vector<MeshView>& meshes) {
+    std::vector<aiMesh*> converted;
+    converted.reserve(meshes.size());
+    for (const MeshView& mesh : meshes) {
+        converted.push_back(createMesh(mesh));
+    }
+    return createScene(converted);
+}
+
+aiScene* createScene(const ObjModel& model) {
+    return createScene(model.views());
+}
+
+ObjMesh extractMesh(const aiMesh* mesh) {
+    ObjMesh out;
+    out.name = mesh->mName.C_Str();
+
+    out.positions.reserve(size_t(mesh->mNumVertices) * 3);
+    for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+        out.positions.insert(out.positions.end(), {mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z});
+    }
+    if (mesh->HasNormals()) {
+        out.normals.reserve(size_t(mesh->mNumVertices) * 3);
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            out.normals.insert(out.normals.end(), {mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z});
+        }
+    }
+    if (mesh->HasTextureCoords(0)) {
+        out.texcoords.reserve(size_t(mesh->mNumVertices) * 2);
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            out.texcoords.insert(out.texcoords.end(), {mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y});
+        }
+    }
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        const aiFace& face = mesh->mFaces[f];
+        for (unsigned int k = 2; k < face.mNumIndices; ++k) {
+            out.indices.insert(out.indices.end(), {face.mIndices[0], face.mIndices[k - 1], face.mIndices[k]});
+        }
+    }
+    return out;
+}
+
+ObjModel extractModel(const aiScene* scene) {
+    ObjModel model;
+    model.meshes.resize(scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        model.meshes[i] = extractMesh(scene->mMeshes[i]);
+    }
+    return model;
+}
+
+void releaseGeometry(aiMesh* mesh) {
+    delete[] mesh->mVertices;
+    mesh->mVertices = nullptr;
+    delete[] mesh->mNormals;
+    mesh->mNormals = nullptr;
+    delete[] mesh->mTextureCoords[0];
+    mesh->mTextureCoords[0] = nullptr;
+    mesh->mNumUVComponents[0] = 0;
+    mesh->mNumVertices = 0;
+    delete[] mesh->mFaces;
+    mesh->mFaces = nullptr;
+    mesh->mNumFaces = 0;
+}
+
+void appendMeshes(aiScene* scene, const std::vector<MeshView>& meshes) {
+    if (meshes.empty()) {
+        return;
+    }
+    const unsigned int oldCount = scene->mNumMeshes;
+    const unsigned int newCount = oldCount + static_cast<unsigned int>(meshes.size());
+
+    aiMesh** sceneMeshes = new aiMesh*[newCount];
+    std::copy(scene->mMeshes, scene->mMeshes + oldCount, sceneMeshes);
+    for (unsigned int i = oldCount; i < newCount; ++i) {
+        sceneMeshes[i] = createMesh(meshes[i - oldCount]);
+    }
+    delete[] scene->mMeshes;
+    scene->mMeshes = sceneMeshes;
+    scene->mNumMeshes = newCount;
+
+    aiNode* root = scene->mRootNode;
+    unsigned int* rootMeshes = new unsigned int[root->mNumMeshes + meshes.size()];
+    std::copy(root->mMeshes, root->mMeshes + root->mNumMeshes, rootMeshes);
+    for (unsigned int i = oldCount; i < newCount; ++i) {
+        rootMeshes[root->mNumMeshes++] = i;
+    }
+    delete[] root->mMeshes;
+    root->mMeshes = rootMeshes;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <assimp/scene.h>
+
+#include <vector>
+
+#include "mesh_view.h"
+#include "obj_parser.h"
+
+// Convertit un mesh natif en aiMesh, pour réutiliser le rendu et la sélection basés sur aiScene
+aiMesh* createMesh(const MeshView& mesh);
+
+// Construit une aiScene possédant ses données (à libérer avec delete) ; tous les meshes
+// sont rattachés au noeud racine, dans l'ordre donné.
+aiScene* createScene(const std::vector<MeshView>& meshes);
+aiScene* createScene(const std::vector<aiMesh*>& meshes); // la scène prend possession des meshes
+aiScene* createScene(const ObjModel& model);
+
+// Opération inverse : copie les meshes triangulés d'une aiScene dans un ObjModel
+ObjMesh extractMesh(const aiMesh* mesh);
+ObjModel extractModel(const aiScene* scene);
+
+// Libère sommets et faces d'un mesh dont une autre représentation sert au rendu ;
+// il ne garde que son nom et son matériau (mNumVertices et mNumFaces valent 0)
+void releaseGeometry(aiMesh* mesh);
+
+// Ajoute des meshes à la fin d'une scène construite par createScene (rattachés au noeud racine)
+void appendMeshes(aiScene* scene, const std::vector<MeshView>& meshes);
@@ -0,0 +1,274 @@
+#include "soft_raster.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "gl_matrix.h"
+#include "parallel.h"
+#include "vertex_pipeline.h"
+
+namespace {
+
+const int kTileSize = 64;
+const size_t kVerticesPerTask = 16 * 1024;
+const size_t kTrianglesPerTask = 16 * 1024;
+const int kSubpixelBits = 8; // coordonnées écran en virgule fixe : 1/256 de pixel
+const float kGuardBand = 4.0f; // découpage latéral seulement au-delà de 4 fois le champ de vision
+
+// Triangle prêt à pixelliser : sommets en virgule fixe (repère fenêtre d'OpenGL, y vers le haut),
+// fonctions d'arête entières (exactes, donc sans fissure ni recouvrement entre triangles voisins)
+struct ScreenTriangle {
+    int64_t x[3], y[3];
+    int64_t edgeA[3], edgeB[3]; // arête i : du sommet i au sommet i+1
+    int64_t bias[3];            // 0 pour une arête haute ou gauche, -1 sinon
+    float area;
+    float depth[3];
+    float inverseW[3];
+    float color[3][3]; // divisée par w, pour l'interpolation en perspective
+    int minX, minY, maxX, maxY; // pixels couverts, bornes incluses
+};
+
+struct TriangleTask {
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins; // indices dans triangles, par tuile
+};
+
+// `colors` : couleur de chaque sommet du triangle découpé
+bool setupTriangle(const ClippedTriangle& clipped, const float colors[3][3], int width, int height, ScreenTriangle& tri) {
+    const float scale = float(1 << kSubpixelBits);
+    for (int k = 0; k < 3; ++k) {
+        tri.x[k] = static_cast<int64_t>(std::lround(clipped.x[k] * scale));
+        tri.y[k] = static_cast<int64_t>(std::lround(clipped.y[k] * scale));
+        tri.depth[k] = clipped.z[k];
+        tri.inverseW[k] = clipped.inverseW[k];
+        for (int c = 0; c < 3; ++c) {
+            tri.color[k][c] = colors[k][c] * clipped.inverseW[k];
+        }
+    }
+    int64_t area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+    if (area == 0) {
+        return false;
+    }
+    if (area < 0) {
+        // Sans élimination des faces arrière : l'ordre des sommets est retourné
+        std::swap(tri.x[1], tri.x[2]);
+        std::swap(tri.y[1], tri.y[2]);
+        std::swap(tri.depth[1], tri.depth[2]);
+        std::swap(tri.inverseW[1], tri.inverseW[2]);
+        std::swap(tri.color[1], tri.color[2]);
+        area = -area;
+    }
+    tri.area = float(area);
+    for (int i = 0; i < 3; ++i) {
+        const int j = (i + 1) % 3;
+        tri.edgeA[i] = tri.y[i] - tri.y[j];
+        tri.edgeB[i] = tri.x[j] - tri.x[i];
+        const bool topLeft = tri.edgeA[i] > 0 || (tri.edgeA[i] == 0 && tri.edgeB[i] < 0);
+        tri.bias[i] = topLeft ? 0 : -1;
+    }
+
+    // Pixels dont le centre peut être couvert, limités à l'écran
+    const int64_t half = int64_t(1) << (kSubpixelBits - 1);
+    const int64_t minX = std::min({tri.x[0], tri.x[1], tri.x[2]}), maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+    const int64_t minY = std::min({tri.y[0], tri.y[1], tri.y[2]}), maxY = std::max({tri.y[0], tri.y[1], tri.y[2]});
+    tri.minX = static_cast<int>(std::max<int64_t>(0, (minX - half) >> kSubpixelBits));
+    tri.minY = static_cast<int>(std::max<int64_t>(0, (minY - half) >> kSubpixelBits));
+    tri.maxX = static_cast<int>(std::min<int64_t>(width - 1, (maxX - half) >> kSubpixelBits));
+    tri.maxY = static_cast<int>(std::min<int64_t>(height - 1, (maxY - half) >> kSubpixelBits));
+    return tri.minX <= tri.maxX && tri.minY <= tri.maxY;
+}
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::min(1.0f, std::max(0.0f, value)) * 255.0f + 0.5f);
+}
+
+} // namespace
+
+void SoftRasterizer::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    pixels_.assign(size_t(width) * height * 3, 0);
+    depth_.assign(size_t(width) * height, 1.0f);
+}
+
+void SoftRasterizer::render(const std::vector<SoftDraw>& draws, const SoftRenderOptions& options, SoftRenderStats* stats) {
+    // Sommets : position de découpage, code de sortie et couleur éclairée, pour tous les meshes à la suite
+    std::vector<size_t> vertexOffsets(draws.size() + 1, 0), triangleOffsets(draws.size() + 1, 0);
+    for (size_t d = 0; d < draws.size(); ++d) {
+        vertexOffsets[d + 1] = vertexOffsets[d] + draws[d].mesh.vertexCount;
+        triangleOffsets[d + 1] = triangleOffsets[d] + draws[d].mesh.indexCount / 3;
+    }
+    const size_t vertexCount = vertexOffsets.back();
+    std::vector<float> clip(vertexCount * 4), colors(vertexCount * 3);
+    std::vector<uint8_t> outcodes(vertexCount);
+    const size_t vertexTasks = (vertexCount + kVerticesPerTask - 1) / kVerticesPerTask;
+    parallelFor(vertexTasks, [&](size_t task) {
+        const size_t first = task * kVerticesPerTask;
+        const size_t last = std::min(vertexCount, first + kVerticesPerTask);
+        size_t d = std::upper_bound(vertexOffsets.begin(), vertexOffsets.end(), first) - vertexOffsets.begin() - 1;
+        // Un lot par mesh touché par la tâche : la transformation passe par le noyau vectoriel
+        for (size_t begin = first; begin < last; ++d) {
+            const size_t end = std::min(last, vertexOffsets[d + 1]);
+            if (begin >= end) {
+                continue;
+            }
+            const SoftDraw& draw = draws[d];
+            float modelView[16], mvp[16], normalMatrix[9];
+            std::copy(options.view, options.view + 16, modelView);
+            matrixMultiply(modelView, draw.model);
+            std::copy(options.projection, options.projection + 16, mvp);
+            matrixMultiply(mvp, modelView);
+            matrixNormal(modelView, normalMatrix);
+            const size_t firstLocal = begin - vertexOffsets[d];
+            transformVertices(mvp, draw.mesh.positions + firstLocal * 3, end - begin, &clip[begin * 4], &outcodes[begin]);
+
+            for (size_t g = begin; g < end; ++g) {
+                // Normale courante par défaut (0, 0, 1) si le mesh n'en a pas, comme glNormal
+                static const float kDefaultNormal[3] = {0.0f, 0.0f, 1.0f};
+                const size_t i = g - vertexOffsets[d];
+                const float* n = draw.mesh.normals ? draw.mesh.normals + i * 3 : kDefaultNormal;
+                float eyeNormal[3];
+                for (int k = 0; k < 3; ++k) {
+                    eyeNormal[k] = normalMatrix[k] * n[0] + normalMatrix[3 + k] * n[1] + normalMatrix[6 + k] * n[2];
+                }
+                float light[3] = {options.ambient[0], options.ambient[1], options.ambient[2]};
+                for (const SoftLight& l : options.lights) {
+                    const float lambert = eyeNormal[0] * l.direction[0] + eyeNormal[1] * l.direction[1] + eyeNormal[2] * l.direction[2];
+                    if (lambert > 0.0f) {
+                        for (int k = 0; k < 3; ++k) {
+                            light[k] += lambert * l.diffuse[k];
+                        }
+                    }
+                }
+                for (int k = 0; k < 3; ++k) {
+                    colors[g * 3 + k] = std::min(1.0f, light[k] * draw.color[k]);
+                }
+            }
+            begin = end;
+        }
+    }, options.numThreads);
+
+    // Triangles : rejet, découpage, mise en place et répartition par tuile ; une tâche par bloc de
+    // triangles consécutifs, pour que la concaténation des tâches garde l'ordre de la scène
+    const int tilesX = (width_ + kTileSize - 1) / kTileSize;
+    const int tilesY = (height_ + kTileSize - 1) / kTileSize;
+    const size_t tileCount = size_t(tilesX) * tilesY;
+    const size_t triangleCount = triangleOffsets.back();
+    std::vector<TriangleTask> tasks((triangleCount + kTrianglesPerTask - 1) / kTrianglesPerTask);
+    parallelFor(tasks.size(), [&](size_t taskIndex) {
+        TriangleTask& task = tasks[taskIndex];
+        task.bins.resize(tileCount);
+        const size_t first = taskIndex * kTrianglesPerTask;
+        const size_t last = std::min(triangleCount, first + kTrianglesPerTask);
+        size_t d = std::upper_bound(triangleOffsets.begin(), triangleOffsets.end(), first) - triangleOffsets.begin() - 1;
+        std::vector<ClippedTriangle> clipped;
+        for (size_t begin = first; begin < last; ++d) {
+            const size_t end = std::min(last, triangleOffsets[d + 1]);
+            if (begin >= end) {
+                continue;
+            }
+            const unsigned int* indices = draws[d].mesh.indices + (begin - triangleOffsets[d]) * 3;
+            const size_t base = vertexOffsets[d];
+            clipped.clear();
+            clipTriangles(&clip[base * 4], &outcodes[base], indices, end - begin, width_, height_, kGuardBand, clipped);
+            for (const ClippedTriangle& triangle : clipped) {
+                // Couleurs des sommets découpés : mêmes poids que leur position
+                const unsigned int* index = indices + size_t(triangle.triangle) * 3;
+                float vertexColors[3][3];
+                for (int k = 0; k < 3; ++k) {
+                    for (int c = 0; c < 3; ++c) {
+                        vertexColors[k][c] = triangle.weights[k][0] * colors[(base + index[0]) * 3 + c] +
+                                             triangle.weights[k][1] * colors[(base + index[1]) * 3 + c] +
+                                             triangle.weights[k][2] * colors[(base + index[2]) * 3 + c];
+                    }
+                }
+                ScreenTriangle tri;
+                if (!setupTriangle(triangle, vertexColors, width_, height_, tri)) {
+                    continue;
+                }
+                const uint32_t local = static_cast<uint32_t>(task.triangles.size());
+                task.triangles.push_back(tri);
+                for (int ty = tri.minY / kTileSize; ty <= tri.maxY / kTileSize; ++ty) {
+                    for (int tx = tri.minX / kTileSize; tx <= tri.maxX / kTileSize; ++tx) {
+                        task.bins[size_t(ty) * tilesX + tx].push_back(local);
+                    }
+                }
+            }
+            begin = end;
+        }
+    }, options.numThreads);
+
+    // Pixellisation : chaque tuile est effacée puis remplie par un seul thread
+    const uint8_t clear[3] = {toByte(options.clearColor[0]), toByte(options.clearColor[1]), toByte(options.clearColor[2])};
+    parallelFor(tileCount, [&](size_t tile) {
+        const int tileX0 = int(tile % tilesX) * kTileSize, tileY0 = int(tile / tilesX) * kTileSize;
+        const int tileX1 = std::min(width_, tileX0 + kTileSize) - 1, tileY1 = std::min(height_, tileY0 + kTileSize) - 1;
+        for (int y = tileY0; y <= tileY1; ++y) {
+            uint8_t* row = &pixels_[(size_t(height_ - 1 - y) * width_ + tileX0) * 3];
+            for (int x = tileX0; x <= tileX1; ++x, row += 3) {
+                row[0] = clear[0];
+                row[1] = clear[1];
+                row[2] = clear[2];
+            }
+            std::fill(&depth_[size_t(y) * width_ + tileX0], &depth_[size_t(y) * width_ + tileX1] + 1, 1.0f);
+        }
+
+        const int64_t half = int64_t(1) << (kSubpixelBits - 1);
+        for (const TriangleTask& task : tasks) {
+            for (uint32_t local : task.bins[tile]) {
+                const ScreenTriangle& tri = task.triangles[local];
+                const int x0 = std::max(tri.minX, tileX0), x1 = std::min(tri.maxX, tileX1);
+                const int y0 = std::max(tri.minY, tileY0), y1 = std::min(tri.maxY, tileY1);
+                if (x0 > x1 || y0 > y1) {
+                    continue;
+                }
+                // Fonctions d'arête au centre du premier pixel, puis incréments par pixel
+                const int64_t px = (int64_t(x0) << kSubpixelBits) + half, py = (int64_t(y0) << kSubpixelBits) + half;
+                int64_t rowEdge[3], stepX[3], stepY[3];
+                for (int i = 0; i < 3; ++i) {
+                    rowEdge[i] = tri.edgeA[i] * (px - tri.x[i]) + tri.edgeB[i] * (py - tri.y[i]) + tri.bias[i];
+                    stepX[i] = tri.edgeA[i] * (int64_t(1) << kSubpixelBits);
+                    stepY[i] = tri.edgeB[i] * (int64_t(1) << kSubpixelBits);
+                }
+                const float inverseArea = 1.0f / tri.area;
+                for (int y = y0; y <= y1; ++y) {
+                    int64_t e[3] = {rowEdge[0], rowEdge[1], rowEdge[2]};
+                    float* depthRow = &depth_[size_t(y) * width_];
+                    uint8_t* pixelRow = &pixels_[size_t(height_ - 1 - y) * width_ * 3];
+                    for (int x = x0; x <= x1; ++x) {
+                        if ((e[0] | e[1] | e[2]) >= 0) {
+                            // Poids du sommet k : arête opposée (k+1), biais retiré
+                            const float w0 = float(e[1] - tri.bias[1]) * inverseArea;
+                            const float w1 = float(e[2] - tri.bias[2]) * inverseArea;
+                            const float w2 = float(e[0] - tri.bias[0]) * inverseArea;
+                            const float z = w0 * tri.depth[0] + w1 * tri.depth[1] + w2 * tri.depth[2];
+                            if (z >= 0.0f && z <= 1.0f && z < depthRow[x]) {
+                                depthRow[x] = z;
+                                const float inverseW = w0 * tri.inverseW[0] + w1 * tri.inverseW[1] + w2 * tri.inverseW[2];
+                                uint8_t* pixel = pixelRow + size_t(x) * 3;
+                                for (int c = 0; c < 3; ++c) {
+                                    pixel[c] = toByte((w0 * tri.color[0][c] + w1 * tri.color[1][c] + w2 * tri.color[2][c]) / inverseW);
+                                }
+                            }
+                        }
+                        e[0] += stepX[0];
+                        e[1] += stepX[1];
+                        e[2] += stepX[2];
+                    }
+                    rowEdge[0] += stepY[0];
+                    rowEdge[1] += stepY[1];
+                    rowEdge[2] += stepY[2];
+                }
+            }
+        }
+    }, options.numThreads);
+
+    if (stats) {
+        stats->trianglesIn = triangleCount;
+        stats->trianglesBinned = 0;
+        for (const TriangleTask& task : tasks) {
+            stats->trianglesBinned += task.triangles.size();
+        }
+        stats->tiles = tileCount;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mesh_view.h"
+
+// Rendu sur le processeur de ce que dessine display() : triangles colorés par mesh, éclairés par
+// des lumières directionnelles (modèle fixe d'OpenGL avec GL_COLOR_MATERIAL : ambiante globale plus
+// diffuse, éclairage par sommet interpolé), test de profondeur, sans fenêtre ni GPU.
+//
+// Trois étapes, chacune répartie sur tous les coeurs : transformation et éclairage des sommets,
+// découpage des triangles contre le plan proche puis répartition dans des tuiles de 64x64 pixels,
+// et pixellisation de chaque tuile par un seul thread. Les triangles d'une tuile sont dessinés dans
+// l'ordre de la scène, quel que soit le nombre de threads : l'image est reproductible à l'octet près.
+
+// Un mesh à dessiner, dans la transformation de son noeud
+struct SoftDraw {
+    MeshView mesh;
+    float model[16]; // colonne par colonne, comme glMultMatrixf
+    float color[4];
+};
+
+// Lumière directionnelle : direction vers la lumière dans le repère de la caméra, couleur diffuse
+struct SoftLight {
+    float direction[3];
+    float diffuse[3];
+};
+
+struct SoftRenderOptions {
+    float view[16];       // matrice modèle-vue de la caméra
+    float projection[16];
+    std::vector<SoftLight> lights;
+    float ambient[3] = {0.2f, 0.2f, 0.2f}; // GL_LIGHT_MODEL_AMBIENT par défaut
+    float clearColor[3] = {0.0f, 0.0f, 0.0f};
+    unsigned int numThreads = 0;
+};
+
+struct SoftRenderStats {
+    size_t trianglesIn = 0;
+    size_t trianglesBinned = 0; // après rejet et découpage
+    size_t tiles = 0;
+};
+
+class SoftRasterizer {
+public:
+    void resize(int width, int height);
+
+    void render(const std::vector<SoftDraw>& draws, const SoftRenderOptions& options, SoftRenderStats* stats = nullptr);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // Pixels RGB, première ligne en haut (même disposition que HeadlessContext::readPixels)
+    const std::vector<uint8_t>& pixels() const { return pixels_; }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<uint8_t> pixels_;
+    std::vector<float> depth_;
+};
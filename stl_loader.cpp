@@ -0,0 +1,92 @@
+#include "stl_loader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "mapped_file.h"
+#include "parallel.h"
+#include "path_utils.h"
+#include "weld.h"
+
+namespace {
+
+const size_t kHeaderBytes = 80;
+const size_t kTriangleBytes = 50; // normale, 3 sommets (12 flottants) puis 2 octets d'attribut
+const size_t kTrianglesPerTask = 64 * 1024;
+
+} // namespace
+
+bool isStlPath(const std::string& path) {
+    return hasExtension(path, ".stl");
+}
+
+bool loadStlBinary(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads) {
+    MappedFile file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    // Le nombre de triangles doit expliquer exactement la taille : c'est ce qui distingue le binaire
+    // d'un STL ASCII (qui commence aussi souvent par "solid")
+    uint32_t triangleCount = 0;
+    if (file.size() >= kHeaderBytes + 4) {
+        std::memcpy(&triangleCount, file.data() + kHeaderBytes, sizeof(triangleCount));
+    }
+    if (file.size() < kHeaderBytes + 4 || file.size() != kHeaderBytes + 4 + size_t(triangleCount) * kTriangleBytes) {
+        if (err) *err = "STL binaire invalide (ou STL ASCII) : " + path;
+        return false;
+    }
+
+    ObjMesh mesh;
+    mesh.name = fileStem(path);
+    const size_t vertexCount = size_t(triangleCount) * 3;
+    mesh.positions.resize(vertexCount * 3);
+    mesh.normals.resize(vertexCount * 3);
+    mesh.indices.resize(vertexCount);
+
+    const char* records = file.data() + kHeaderBytes + 4;
+    const size_t tasks = (size_t(triangleCount) + kTrianglesPerTask - 1) / kTrianglesPerTask;
+    parallelFor(tasks, [&](size_t task) {
+        const size_t first = task * kTrianglesPerTask;
+        const size_t last = std::min<size_t>(first + kTrianglesPerTask, triangleCount);
+        float* positions = mesh.positions.data() + first * 9;
+        float* normals = mesh.normals.data() + first * 9;
+        for (size_t t = first; t < last; ++t, positions += 9, normals += 9) {
+            const char* record = records + t * kTriangleBytes;
+            // Les 9 flottants des sommets sont contigus : une seule copie (instructions vectorielles)
+            std::memcpy(positions, record + 12, 9 * sizeof(float));
+            float n[3];
+            std::memcpy(n, record, sizeof(n));
+            if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) {
+                const float e1[3] = {positions[3] - positions[0], positions[4] - positions[1], positions[5] - positions[2]};
+                const float e2[3] = {positions[6] - positions[0], positions[7] - positions[1], positions[8] - positions[2]};
+                n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+                n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+                n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+                const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length > 0.0f) {
+                    n[0] /= length;
+                    n[1] /= length;
+                    n[2] /= length;
+                }
+            }
+            for (int corner = 0; corner < 3; ++corner) {
+                std::memcpy(normals + corner * 3, n, sizeof(n));
+            }
+        }
+        for (size_t v = first * 3; v < last * 3; ++v) {
+            mesh.indices[v] = static_cast<unsigned int>(v);
+        }
+    }, numThreads);
+
+    // Le STL n'a pas d'indices : les coins identiques sont fusionnés
+    WeldOptions options;
+    options.numThreads = numThreads;
+    weldMesh(mesh, options);
+
+    model.meshes.clear();
+    if (!mesh.indices.empty()) {
+        model.meshes.push_back(std::move(mesh));
+    }
+    return true;
+}
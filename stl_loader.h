@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include "obj_parser.h"
+
+// Chargeur STL binaire : les enregistrements de 50 octets sont recopiés par blocs en parallèle
+// (trois sommets par triangle, normale de facette recalculée si elle est nulle), puis les sommets
+// identiques sont fusionnés en parallèle par weldMesh pour retrouver des indices. Les arêtes vives
+// restent nettes : seuls les coins de même position et de même normale sont fusionnés.
+// Le STL ASCII n'est pas pris en charge (erreur : le laisser à Assimp).
+bool loadStlBinary(const std::string& path, ObjModel& model, std::string* err, unsigned int numThreads = 0);
+
+// Vrai si le chemin désigne un fichier .stl (sans tenir compte de la casse)
+bool isStlPath(const std::string& path);
@@ -0,0 +1,215 @@
+#include "vertex_pipeline.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define VERTEX_PIPELINE_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VERTEX_PIPELINE_SSE2 1
+#endif
+
+namespace {
+
+const int kMaxClipVertices = 9; // 3 sommets plus un par plan de découpage
+
+// Sommet pendant le découpage : position de découpage et poids des sommets d'origine
+struct ClipPoint {
+    float position[4];
+    float weights[3];
+};
+
+inline uint8_t outcode(const float* p) {
+    const float w = p[3];
+    return static_cast<uint8_t>((p[0] < -w ? kClipLeft : 0) | (p[1] < -w ? kClipBottom : 0) | (p[2] < -w ? kClipNear : 0) |
+                                (p[0] > w ? kClipRight : 0) | (p[1] > w ? kClipTop : 0) | (p[2] > w ? kClipFar : 0));
+}
+
+inline void transformScalar(const float m[16], const float* p, float* out) {
+    for (int row = 0; row < 4; ++row) {
+        out[row] = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+    }
+}
+
+// Garde la partie du polygone où plane[0..3] . position >= 0 (Sutherland-Hodgman)
+int clipPolygon(const ClipPoint* in, int count, const float plane[4], ClipPoint* out) {
+    int written = 0;
+    for (int i = 0; i < count; ++i) {
+        const ClipPoint& a = in[i];
+        const ClipPoint& b = in[(i + 1) % count];
+        const float da = plane[0] * a.position[0] + plane[1] * a.position[1] + plane[2] * a.position[2] + plane[3] * a.position[3];
+        const float db = plane[0] * b.position[0] + plane[1] * b.position[1] + plane[2] * b.position[2] + plane[3] * b.position[3];
+        if (da >= 0.0f) {
+            out[written++] = a;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f)) {
+            const float t = da / (da - db);
+            ClipPoint& v = out[written++];
+            for (int k = 0; k < 4; ++k) {
+                v.position[k] = a.position[k] + t * (b.position[k] - a.position[k]);
+            }
+            for (int k = 0; k < 3; ++k) {
+                v.weights[k] = a.weights[k] + t * (b.weights[k] - a.weights[k]);
+            }
+        }
+    }
+    return written;
+}
+
+void emitTriangle(const ClipPoint* a, const ClipPoint* b, const ClipPoint* c, float width, float height, uint32_t triangle,
+                  std::vector<ClippedTriangle>& out) {
+    const ClipPoint* v[3] = {a, b, c};
+    ClippedTriangle tri;
+    for (int k = 0; k < 3; ++k) {
+        const float inverseW = 1.0f / v[k]->position[3];
+        tri.x[k] = (v[k]->position[0] * inverseW * 0.5f + 0.5f) * width;
+        tri.y[k] = (v[k]->position[1] * inverseW * 0.5f + 0.5f) * height;
+        tri.z[k] = v[k]->position[2] * inverseW * 0.5f + 0.5f;
+        tri.inverseW[k] = inverseW;
+        for (int j = 0; j < 3; ++j) {
+            tri.weights[k][j] = v[k]->weights[j];
+        }
+    }
+    tri.triangle = triangle;
+    out.push_back(tri);
+}
+
+} // namespace
+
+const char* vertexPipelineKernel() {
+#if defined(VERTEX_PIPELINE_AVX2)
+    return "avx2";
+#elif defined(VERTEX_PIPELINE_SSE2)
+    return "sse2";
+#else
+    return "scalaire";
+#endif
+}
+
+ClipSummary transformVertices(const float mvp[16], const float* positions, size_t count, float* clip, uint8_t* outcodes) {
+    ClipSummary summary;
+    size_t i = 0;
+#if defined(VERTEX_PIPELINE_AVX2)
+    // Deux sommets par registre : colonnes de la matrice répétées dans chaque moitié
+    __m128 columns[4];
+    for (int c = 0; c < 4; ++c) {
+        columns[c] = _mm_loadu_ps(mvp + c * 4);
+    }
+    const __m256 c0 = _mm256_broadcast_ps(&columns[0]), c1 = _mm256_broadcast_ps(&columns[1]);
+    const __m256 c2 = _mm256_broadcast_ps(&columns[2]), c3 = _mm256_broadcast_ps(&columns[3]);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    for (; i + 2 <= count; i += 2) {
+        const float* p = positions + i * 3;
+        const __m256 x = _mm256_set_m128(_mm_set1_ps(p[3]), _mm_set1_ps(p[0]));
+        const __m256 y = _mm256_set_m128(_mm_set1_ps(p[4]), _mm_set1_ps(p[1]));
+        const __m256 z = _mm256_set_m128(_mm_set1_ps(p[5]), _mm_set1_ps(p[2]));
+        const __m256 v = _mm256_fmadd_ps(c0, x, _mm256_fmadd_ps(c1, y, _mm256_fmadd_ps(c2, z, c3)));
+        _mm256_storeu_ps(clip + i * 4, v);
+        const __m256 w = _mm256_permute_ps(v, 0xff);
+        const int below = _mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_xor_ps(w, sign), _CMP_LT_OQ));
+        const int above = _mm256_movemask_ps(_mm256_cmp_ps(v, w, _CMP_GT_OQ));
+        const uint8_t code0 = static_cast<uint8_t>((below & 7) | ((above & 7) << 3));
+        const uint8_t code1 = static_cast<uint8_t>(((below >> 4) & 7) | (((above >> 4) & 7) << 3));
+        outcodes[i] = code0;
+        outcodes[i + 1] = code1;
+        summary.any |= code0 | code1;
+        summary.all &= code0 & code1;
+    }
+#elif defined(VERTEX_PIPELINE_SSE2)
+    const __m128 c0 = _mm_loadu_ps(mvp), c1 = _mm_loadu_ps(mvp + 4);
+    const __m128 c2 = _mm_loadu_ps(mvp + 8), c3 = _mm_loadu_ps(mvp + 12);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i < count; ++i) {
+        const float* p = positions + i * 3;
+        const __m128 v = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p[0])), _mm_mul_ps(c1, _mm_set1_ps(p[1]))),
+                                               _mm_mul_ps(c2, _mm_set1_ps(p[2]))),
+                                    c3);
+        _mm_storeu_ps(clip + i * 4, v);
+        const __m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+        const int below = _mm_movemask_ps(_mm_cmplt_ps(v, _mm_xor_ps(w, sign)));
+        const int above = _mm_movemask_ps(_mm_cmpgt_ps(v, w));
+        const uint8_t code = static_cast<uint8_t>((below & 7) | ((above & 7) << 3));
+        outcodes[i] = code;
+        summary.any |= code;
+        summary.all &= code;
+    }
+#endif
+    for (; i < count; ++i) {
+        transformScalar(mvp, positions + i * 3, clip + i * 4);
+        const uint8_t code = outcode(clip + i * 4);
+        outcodes[i] = code;
+        summary.any |= code;
+        summary.all &= code;
+    }
+    return summary;
+}
+
+bool boxOutsideFrustum(const float mvp[16], const float min[3], const float max[3]) {
+    if (min[0] > max[0] || min[1] > max[1] || min[2] > max[2]) {
+        return false;
+    }
+    float corners[8 * 3];
+    for (int c = 0; c < 8; ++c) {
+        corners[c * 3] = c & 1 ? max[0] : min[0];
+        corners[c * 3 + 1] = c & 2 ? max[1] : min[1];
+        corners[c * 3 + 2] = c & 4 ? max[2] : min[2];
+    }
+    float clip[8 * 4];
+    uint8_t outcodes[8];
+    return transformVertices(mvp, corners, 8, clip, outcodes).all != 0;
+}
+
+void clipTriangles(const float* clip, const uint8_t* outcodes, const unsigned int* indices, size_t triangleCount,
+                   int viewportWidth, int viewportHeight, float guardBand, std::vector<ClippedTriangle>& out) {
+    const float width = float(viewportWidth), height = float(viewportHeight);
+    const float planes[6][4] = {{0, 0, 1, 1}, {0, 0, -1, 1},
+                                {1, 0, 0, guardBand}, {-1, 0, 0, guardBand},
+                                {0, 1, 0, guardBand}, {0, -1, 0, guardBand}};
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* index = indices + t * 3;
+        const uint8_t a = outcodes[index[0]], b = outcodes[index[1]], c = outcodes[index[2]];
+        if (a & b & c) {
+            continue; // les trois sommets du même côté extérieur d'un plan
+        }
+        const uint32_t triangle = static_cast<uint32_t>(t);
+        ClipPoint polygon[2][kMaxClipVertices];
+        for (int k = 0; k < 3; ++k) {
+            const float* p = clip + size_t(index[k]) * 4;
+            ClipPoint& v = polygon[0][k];
+            v.position[0] = p[0];
+            v.position[1] = p[1];
+            v.position[2] = p[2];
+            v.position[3] = p[3];
+            v.weights[0] = k == 0 ? 1.0f : 0.0f;
+            v.weights[1] = k == 1 ? 1.0f : 0.0f;
+            v.weights[2] = k == 2 ? 1.0f : 0.0f;
+        }
+        if ((a | b | c) == 0) {
+            emitTriangle(&polygon[0][0], &polygon[0][1], &polygon[0][2], width, height, triangle, out);
+            continue;
+        }
+
+        // Plans proche et lointain d'après les codes ; ensuite seulement les côtés, d'après la bande
+        // de garde, car les sommets créés sur le plan proche peuvent en sortir
+        bool needed[6] = {((a | b | c) & kClipNear) != 0, ((a | b | c) & kClipFar) != 0, false, false, false, false};
+        int count = 3, current = 0;
+        for (int plane = 0; plane < 6 && count >= 3; ++plane) {
+            if (plane == 2) {
+                for (int k = 0; k < count; ++k) {
+                    const float* p = polygon[current][k].position;
+                    const float limit = guardBand * p[3];
+                    needed[2] = needed[2] || p[0] < -limit;
+                    needed[3] = needed[3] || p[0] > limit;
+                    needed[4] = needed[4] || p[1] < -limit;
+                    needed[5] = needed[5] || p[1] > limit;
+                }
+            }
+            if (needed[plane]) {
+                count = clipPolygon(polygon[current], count, planes[plane], polygon[1 - current]);
+                current = 1 - current;
+            }
+        }
+        for (int k = 1; k + 1 < count; ++k) {
+            emitTriangle(&polygon[current][0], &polygon[current][k], &polygon[current][k + 1], width, height, triangle, out);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Étape sommets commune aux chemins sur le processeur (rendu logiciel, sélection, élimination des
+// meshes hors champ) : transformation par la matrice modèle-vue-projection, classement contre le
+// volume de vue en coordonnées de découpage, puis découpage des triangles et passage en coordonnées
+// fenêtre. La transformation est vectorisée (AVX2 et FMA si le compilateur les active, sinon SSE2,
+// sinon code scalaire) ; les versions ne diffèrent que par l'arrondi (FMA en AVX2).
+
+// Bits du code de sortie d'un sommet : plans du volume de vue dépassés (|x|, |y|, |z| > w)
+enum ClipPlaneBits : uint8_t {
+    kClipLeft = 1,   // x < -w
+    kClipBottom = 2, // y < -w
+    kClipNear = 4,   // z < -w
+    kClipRight = 8,  // x > w
+    kClipTop = 16,   // y > w
+    kClipFar = 32,   // z > w
+};
+
+// Union et intersection des codes d'un lot : `all` non nul signifie le lot entier hors champ
+struct ClipSummary {
+    uint8_t any = 0;
+    uint8_t all = 0x3f;
+};
+
+// Triangle découpé, en coordonnées fenêtre (pixels, origine en bas à gauche comme glViewport),
+// profondeur dans [0, 1]. `weights` donne chaque sommet comme combinaison des trois sommets du
+// triangle d'origine, en coordonnées de découpage : l'appelant y interpole ses propres attributs.
+struct ClippedTriangle {
+    float x[3], y[3], z[3];
+    float inverseW[3];
+    float weights[3][3];
+    uint32_t triangle; // indice du triangle d'origine dans l'appel
+};
+
+// Nom du noyau compilé : "avx2", "sse2" ou "scalaire"
+const char* vertexPipelineKernel();
+
+// positions : x, y, z par sommet ; clip reçoit x, y, z, w par sommet, outcodes un octet par sommet
+ClipSummary transformVertices(const float mvp[16], const float* positions, size_t count, float* clip, uint8_t* outcodes);
+
+// Vrai si la boîte [min, max] est entièrement hors du volume de vue de mvp. Une boîte vide
+// (min > max) n'est jamais éliminée.
+bool boxOutsideFrustum(const float mvp[16], const float min[3], const float max[3]);
+
+// Découpe les triangles d'indices `indices` (sommets déjà transformés) et ajoute à `out` ceux qui
+// restent. Les triangles entièrement d'un côté d'un plan sont rejetés ; les autres sont découpés
+// contre les plans proche et lointain et, sur les côtés, contre |x|, |y| <= guardBand * w : 1 pour
+// garder exactement le champ (sélection), davantage pour laisser la pixellisation rogner à l'écran.
+void clipTriangles(const float* clip, const uint8_t* outcodes, const unsigned int* indices, size_t triangleCount,
+                   int viewportWidth, int viewportHeight, float guardBand, std::vector<ClippedTriangle>& out);
@@ -0,0 +1,208 @@
+#include "weld.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Au-delà, un mesh est fusionné seul avec tous les threads plutôt qu'en parallèle avec les autres
+const size_t kLargeMeshVertices = 1 << 16;
+
+int32_t quantize(float value, float inverseEpsilon) {
+    if (inverseEpsilon == 0.0f) {
+        if (value == 0.0f) {
+            return 0; // confond 0 et -0
+        }
+        int32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    return static_cast<int32_t>(std::lround(value * inverseEpsilon));
+}
+
+VertexKey makeKey(const ObjMesh& mesh, size_t v, float inverseEpsilon) {
+    return makeVertexKey(&mesh.positions[v * 3], mesh.normals.empty() ? nullptr : &mesh.normals[v * 3],
+                         mesh.texcoords.empty() ? nullptr : &mesh.texcoords[v * 2], inverseEpsilon);
+}
+
+size_t meshBytes(const ObjMesh& mesh) {
+    return (mesh.positions.size() + mesh.normals.size() + mesh.texcoords.size()) * sizeof(float) +
+           mesh.indices.size() * sizeof(unsigned int);
+}
+
+// Pour chaque sommet, indice du premier sommet équivalent (lui-même s'il est le premier).
+// Les sommets sont répartis en partitions selon leur empreinte, chaque partition étant
+// traitée par un seul thread : aucune table partagée, et un résultat indépendant du nombre de threads.
+std::vector<unsigned int> findRepresentatives(const ObjMesh& mesh, float inverseEpsilon, unsigned int numThreads) {
+    const size_t count = mesh.vertexCount();
+    const size_t partitions = workerCount(numThreads);
+    const size_t block = 4096;
+    const size_t blocks = (count + block - 1) / block;
+
+    // Clés, empreintes et nombre de sommets de chaque bloc dans chaque partition
+    std::vector<VertexKey> keys(count);
+    std::vector<size_t> hashes(count);
+    std::vector<size_t> offsets(blocks * partitions, 0);
+    parallelFor(blocks, [&](size_t b) {
+        VertexKeyHash hasher;
+        for (size_t v = b * block; v < std::min(count, (b + 1) * block); ++v) {
+            keys[v] = makeKey(mesh, v, inverseEpsilon);
+            hashes[v] = hasher(keys[v]);
+            ++offsets[b * partitions + hashes[v] % partitions];
+        }
+    }, numThreads);
+
+    // Somme préfixe partition par partition, puis bloc par bloc : les membres d'une partition sont
+    // contigus et rangés dans l'ordre des sommets, le premier vu restant le représentant
+    std::vector<size_t> partitionStart(partitions + 1, 0);
+    size_t total = 0;
+    for (size_t part = 0; part < partitions; ++part) {
+        partitionStart[part] = total;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t n = offsets[b * partitions + part];
+            offsets[b * partitions + part] = total;
+            total += n;
+        }
+    }
+    partitionStart[partitions] = total;
+
+    std::vector<unsigned int> members(count);
+    parallelFor(blocks, [&](size_t b) {
+        size_t* next = &offsets[b * partitions];
+        for (size_t v = b * block; v < std::min(count, (b + 1) * block); ++v) {
+            members[next[hashes[v] % partitions]++] = static_cast<unsigned int>(v);
+        }
+    }, numThreads);
+
+    // Table à adressage ouvert par partition, dimensionnée d'après ses membres (au plus à moitié
+    // pleine), qui ne stocke que l'indice du premier sommet vu
+    const unsigned int kEmpty = ~0u;
+    std::vector<unsigned int> representative(count);
+    parallelFor(partitions, [&](size_t part) {
+        const size_t first = partitionStart[part], last = partitionStart[part + 1];
+        size_t capacity = 16;
+        while (capacity < 2 * (last - first)) {
+            capacity *= 2;
+        }
+        std::vector<unsigned int> table(capacity, kEmpty);
+        const size_t mask = capacity - 1;
+        for (size_t m = first; m < last; ++m) {
+            const unsigned int v = members[m];
+            size_t slot = (hashes[v] / partitions) & mask;
+            while (table[slot] != kEmpty && !(keys[table[slot]] == keys[v])) {
+                slot = (slot + 1) & mask;
+            }
+            if (table[slot] == kEmpty) {
+                table[slot] = v;
+            }
+            representative[v] = table[slot];
+        }
+    }, numThreads);
+    return representative;
+}
+
+} // namespace
+
+VertexKey makeVertexKey(const float* position, const float* normal, const float* texcoord, float inverseEpsilon) {
+    VertexKey key = {};
+    for (unsigned int c = 0; c < 3; ++c) {
+        key.q[c] = quantize(position[c], inverseEpsilon);
+    }
+    if (normal) {
+        for (unsigned int c = 0; c < 3; ++c) {
+            key.q[3 + c] = quantize(normal[c], inverseEpsilon);
+        }
+    }
+    if (texcoord) {
+        for (unsigned int c = 0; c < 2; ++c) {
+            key.q[6 + c] = quantize(texcoord[c], inverseEpsilon);
+        }
+    }
+    return key;
+}
+
+void weldMesh(ObjMesh& mesh, const WeldOptions& options, WeldStats* stats) {
+    const size_t count = mesh.vertexCount();
+    if (stats) {
+        stats->verticesBefore += count;
+        stats->bytesBefore += meshBytes(mesh);
+    }
+
+    const float inverseEpsilon = options.epsilon > 0.0f ? 1.0f / options.epsilon : 0.0f;
+    const std::vector<unsigned int> representative = findRepresentatives(mesh, inverseEpsilon, options.numThreads);
+
+    // Les sommets conservés gardent leur ordre d'origine
+    std::vector<unsigned int> remap(count);
+    size_t kept = 0;
+    for (size_t v = 0; v < count; ++v) {
+        if (representative[v] == v) {
+            if (kept != v) {
+                std::memcpy(&mesh.positions[kept * 3], &mesh.positions[v * 3], 3 * sizeof(float));
+                if (!mesh.normals.empty()) {
+                    std::memcpy(&mesh.normals[kept * 3], &mesh.normals[v * 3], 3 * sizeof(float));
+                }
+                if (!mesh.texcoords.empty()) {
+                    std::memcpy(&mesh.texcoords[kept * 2], &mesh.texcoords[v * 2], 2 * sizeof(float));
+                }
+            }
+            remap[v] = static_cast<unsigned int>(kept++);
+        } else {
+            remap[v] = remap[representative[v]];
+        }
+    }
+    mesh.positions.resize(kept * 3);
+    if (!mesh.normals.empty()) {
+        mesh.normals.resize(kept * 3);
+    }
+    if (!mesh.texcoords.empty()) {
+        mesh.texcoords.resize(kept * 2);
+    }
+
+    size_t out = 0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        unsigned int a = remap[mesh.indices[t]];
+        unsigned int b = remap[mesh.indices[t + 1]];
+        unsigned int c = remap[mesh.indices[t + 2]];
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        mesh.indices[out++] = a;
+        mesh.indices[out++] = b;
+        mesh.indices[out++] = c;
+    }
+    mesh.indices.resize(out);
+
+    if (stats) {
+        stats->verticesAfter += kept;
+        stats->bytesAfter += meshBytes(mesh);
+    }
+}
+
+void weldModel(ObjModel& model, const WeldOptions& options, WeldStats* stats) {
+    std::vector<size_t> small;
+    std::vector<WeldStats> meshStats(model.meshes.size());
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        if (model.meshes[i].vertexCount() >= kLargeMeshVertices) {
+            weldMesh(model.meshes[i], options, &meshStats[i]);
+        } else {
+            small.push_back(i);
+        }
+    }
+
+    WeldOptions serial = options;
+    serial.numThreads = 1;
+    parallelFor(small.size(), [&](size_t s) {
+        weldMesh(model.meshes[small[s]], serial, &meshStats[small[s]]);
+    }, options.numThreads);
+
+    if (stats) {
+        for (const WeldStats& meshStat : meshStats) {
+            stats->verticesBefore += meshStat.verticesBefore;
+            stats->verticesAfter += meshStat.verticesAfter;
+            stats->bytesBefore += meshStat.bytesBefore;
+            stats->bytesAfter += meshStat.bytesAfter;
+        }
+    }
+}
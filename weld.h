@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "obj_parser.h"
+
+// Fusion des sommets identiques (position, normale, uv), en remplacement de
+// aiProcess_JoinIdenticalVertices. Les composantes sont arrondies à une grille de pas epsilon
+// avant hachage : deux sommets sont fusionnés s'ils tombent dans la même cellule.
+// epsilon = 0 ne fusionne que les sommets strictement égaux (0 et -0 confondus).
+struct WeldOptions {
+    float epsilon = 0.0f;
+    unsigned int numThreads = 0; // 0 = tous les coeurs
+};
+
+// Clé de fusion d'un sommet : position, normale et uv arrondies à la grille (bits exacts si
+// inverseEpsilon = 0). Aussi utilisée par l'arène de géométrie, qui fusionne les coins à la lecture.
+struct VertexKey {
+    int32_t q[8]; // xyz, normale, uv ; 0 pour un attribut absent
+
+    bool operator==(const VertexKey& other) const { return std::memcmp(q, other.q, sizeof(q)) == 0; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (int32_t value : key.q) {
+            h = (h ^ static_cast<uint32_t>(value)) * 0x100000001b3ull;
+        }
+        // Brassage final : les bits bas et hauts servent au choix de la partition et de la case
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
+
+// normal et texcoord peuvent être nuls
+VertexKey makeVertexKey(const float* position, const float* normal, const float* texcoord, float inverseEpsilon);
+
+struct WeldStats {
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+};
+
+// Fusionne les sommets d'un mesh ; les triangles devenus dégénérés sont supprimés
+void weldMesh(ObjMesh& mesh, const WeldOptions& options, WeldStats* stats = nullptr);
+
+// Fusionne tous les meshes : les petits meshes sont traités en parallèle entre eux,
+// les gros meshes un par un avec le hachage réparti sur tous les threads
+void weldModel(ObjModel& model, const WeldOptions& options, WeldStats* stats = nullptr);